@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Common.h"
+#include "KeyCodes.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Shared helpers for the benchmarks in this directory. Each benchmark is a
+// standalone executable that prints one line per case; run Release builds.
+namespace BenchUtil
+{
+    // Keeps the optimizer from discarding a result that is otherwise unused
+    template <typename T>
+    inline void KeepAlive(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    inline double NowNs()
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Runs 'body' 'iterations' times per round and returns the best round's
+    // time per iteration in nanoseconds; the first round doubles as warm-up
+    template <typename Body>
+    double MeasureNs(int iterations, Body&& body, int rounds = 5)
+    {
+        double best = 1e300;
+        for (int round = 0; round <= rounds; ++round)
+        {
+            double start = NowNs();
+            for (int i = 0; i < iterations; ++i)
+                body();
+            double perIteration = (NowNs() - start) / iterations;
+            if (round > 0)
+                best = std::min(best, perIteration);
+        }
+        return best;
+    }
+
+    // Native preset with 'elementCount' keyboard elements on a 100-column
+    // grid, cycling through the key table. Every element has a pressed rect;
+    // every 50th is a wheel with up/down rects and every 100th a cursor.
+    inline std::string MakeSyntheticPreset(int elementCount)
+    {
+        const int columns = 100;
+        const int rows = (elementCount + columns - 1) / columns;
+
+        std::string json;
+        json.reserve(static_cast<size_t>(elementCount) * 400);
+        json += "{\n  \"version\": 1,\n";
+        json += "  \"texture\": { \"file\": \"keyboard.png\", \"size\": [4096, 4096] },\n";
+        json += "  \"canvas\": { \"size\": [" + std::to_string(columns * 54) + ", " + std::to_string(rows * 54) +
+                "], \"background\": [0, 0, 0, 0] },\n";
+        json += "  \"defaults\": { \"pressed_offset\": [0, 2048] },\n";
+        json += "  \"elements\": [\n";
+
+        for (int i = 0; i < elementCount; ++i)
+        {
+            const KeyCodes::KeyCodeEntry& key = KeyCodes::KEY_CODE_TABLE[i % KeyCodes::KEY_CODE_COUNT];
+            int x = (i % columns) * 54;
+            int y = (i / columns) * 54;
+            std::string rect = std::to_string(x) + ", " + std::to_string(y) + ", 50, 50";
+            std::string pressed = std::to_string(x) + ", " + std::to_string(y + 2048) + ", 50, 50";
+
+            json += "    {\n      \"id\": \"" + std::string(key.name) + "_" + std::to_string(i) + "\",\n";
+            json += "      \"codes\": { \"hid\": " + std::to_string(key.hid) + ", \"winvk\": " + std::to_string(key.vk) +
+                    ", \"evdev\": " + std::to_string(key.evdev) + " },\n";
+            json += "      \"pos\": [" + std::to_string(x) + ", " + std::to_string(y) + "],\n";
+            json += "      \"sprite\": { \"normal\": [" + rect + "], \"pressed\": [" + pressed + "]";
+            if (i % 50 == 0)
+                json += ", \"up\": [" + rect + "], \"down\": [" + pressed + "]";
+            json += " },\n";
+            if (i % 50 == 0)
+                json += "      \"wheel\": true,\n";
+            if (i % 100 == 0)
+                json += "      \"cursor\": { \"mode\": \"dot\", \"radius\": 40 },\n";
+            json += "      \"z\": " + std::to_string(i % 4) + "\n    }";
+            json += i + 1 < elementCount ? ",\n" : "\n";
+        }
+
+        json += "  ]\n}\n";
+        return json;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "BenchUtil.h"
+#include "ConfigParser.h"
+#include "JSONDocument.h"
+#include <cstdlib>
+
+// Parse time of a synthetic full-keyboard preset, with and without building
+// the OverlayConfig on top of the JSON tape.
+int main(int argc, char* argv[])
+{
+    int elementCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000;
+    std::string json = BenchUtil::MakeSyntheticPreset(elementCount);
+    double megabytes = json.size() / (1024.0 * 1024.0);
+
+    ConfigParser parser;
+    OverlayConfig check;
+    if (!parser.ParseFromString(json, check) || check.elements.size() != static_cast<size_t>(elementCount))
+    {
+        std::fprintf(stderr, "Synthetic preset did not parse\n");
+        return 1;
+    }
+
+    std::printf("synthetic preset: %d elements, %.0f KB\n", elementCount, json.size() / 1024.0);
+
+    double tokenizeNs = BenchUtil::MeasureNs(50, [&]()
+    {
+        JSONDocument document;
+        document.Parse(json);
+        BenchUtil::KeepAlive(document);
+    });
+    std::printf("  %-30s %8.3f ms  %7.1f MB/s\n", "JSONDocument::Parse", tokenizeNs / 1e6, megabytes / (tokenizeNs / 1e9));
+
+    double parseNs = BenchUtil::MeasureNs(50, [&]()
+    {
+        OverlayConfig config;
+        parser.ParseFromString(json, config);
+        BenchUtil::KeepAlive(config);
+    });
+    std::printf("  %-30s %8.3f ms  %7.1f MB/s\n", "ConfigParser::ParseFromString", parseNs / 1e6, megabytes / (parseNs / 1e9));
+    return 0;
+}
\ No newline at end of file
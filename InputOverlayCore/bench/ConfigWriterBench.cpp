@@ -0,0 +1,33 @@
+#include "BenchUtil.h"
+#include "ConfigParser.h"
+#include <cstdlib>
+
+// Serialization throughput of a large config: ConfigToJSON as sent over IPC
+// (compact) and as written to preset files (indented).
+int main(int argc, char* argv[])
+{
+    int elementCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000;
+
+    ConfigParser parser;
+    OverlayConfig config;
+    if (!parser.ParseFromString(BenchUtil::MakeSyntheticPreset(elementCount), config))
+    {
+        std::fprintf(stderr, "Synthetic preset did not parse\n");
+        return 1;
+    }
+
+    std::printf("synthetic config: %d elements\n", elementCount);
+
+    for (bool pretty : { false, true })
+    {
+        size_t bytes = parser.ConfigToJSON(config, pretty).size();
+        double writeNs = BenchUtil::MeasureNs(50, [&]()
+        {
+            std::string json = parser.ConfigToJSON(config, pretty);
+            BenchUtil::KeepAlive(json);
+        });
+        std::printf("  %-30s %6.0f KB %8.3f ms  %7.1f MB/s\n", pretty ? "ConfigToJSON (pretty)" : "ConfigToJSON",
+                    bytes / 1024.0, writeNs / 1e6, bytes / (1024.0 * 1024.0) / (writeNs / 1e9));
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "BenchUtil.h"
+#include "KeyState.h"
+#include <map>
+
+// One simulated input frame against the std::map<int, bool> key state that
+// KeyStateSet replaced: copy the previous frame, apply key edges, look up the
+// keys an overlay draws and find this frame's presses.
+namespace
+{
+    const int EDGES_PER_FRAME = 48;
+    const int LOOKUPS_PER_FRAME = 10;
+
+    // Deterministic key codes spread over the whole table
+    int KeyAt(int frame, int i)
+    {
+        return 8 + ((frame * 31 + i * 17) % (KeyStateSet::KEY_COUNT - 8));
+    }
+
+    struct MapKeyStates
+    {
+        std::map<int, bool> current;
+        std::map<int, bool> previous;
+        int frame = 0;
+
+        int Update()
+        {
+            previous = current;
+            for (int i = 0; i < EDGES_PER_FRAME; ++i)
+                current[KeyAt(frame, i)] = ((frame + i) & 1) != 0;
+
+            int visible = 0;
+            for (int i = 0; i < LOOKUPS_PER_FRAME; ++i)
+            {
+                auto it = current.find(KeyAt(0, i));
+                visible += it != current.end() && it->second;
+            }
+
+            // Pressed edges: down now, up (or absent) before
+            for (const auto& entry : current)
+            {
+                if (!entry.second)
+                    continue;
+                auto before = previous.find(entry.first);
+                visible += before == previous.end() || !before->second;
+            }
+
+            ++frame;
+            return visible;
+        }
+    };
+
+    struct BitsetKeyStates
+    {
+        KeyStateSet current;
+        KeyStateSet previous;
+        int frame = 0;
+
+        int Update()
+        {
+            previous = current;
+            for (int i = 0; i < EDGES_PER_FRAME; ++i)
+                current.Set(KeyAt(frame, i), ((frame + i) & 1) != 0);
+
+            int visible = 0;
+            for (int i = 0; i < LOOKUPS_PER_FRAME; ++i)
+                visible += current.Test(KeyAt(0, i));
+
+            KeyStateSet pressed = KeyStateSet::Pressed(previous, current);
+            pressed.ForEach([&](int) { ++visible; });
+
+            ++frame;
+            return visible;
+        }
+    };
+}
+
+int main()
+{
+    const int frames = 200000;
+    std::printf("per frame: %d key edges, previous-frame copy, %d lookups, pressed edges\n",
+                EDGES_PER_FRAME, LOOKUPS_PER_FRAME);
+
+    MapKeyStates mapStates;
+    int mapVisible = 0;
+    double mapNs = BenchUtil::MeasureNs(frames, [&]() { mapVisible += mapStates.Update(); });
+
+    BitsetKeyStates bitsetStates;
+    int bitsetVisible = 0;
+    double bitsetNs = BenchUtil::MeasureNs(frames, [&]() { bitsetVisible += bitsetStates.Update(); });
+
+    // Both ran the same number of frames, so they must agree
+    if (mapVisible != bitsetVisible)
+    {
+        std::fprintf(stderr, "Results differ: map %d, KeyStateSet %d\n", mapVisible, bitsetVisible);
+        return 1;
+    }
+
+    std::printf("  %-24s %8.1f ns/frame\n", "std::map<int, bool>", mapNs);
+    std::printf("  %-24s %8.1f ns/frame\n", "KeyStateSet", bitsetNs);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "BenchUtil.h"
+#include "IPCManager.h"
+#include "JSONDocument.h"
+#include "MouseEventCodec.h"
+#include <cstdlib>
+#include <vector>
+
+// MOUSE_EVENT payload per 60 Hz frame: the JSON object the core used to build
+// from end-of-frame mouse state and parse with JSONDocument, against a
+// MouseEventCodec packet of the frame's samples. The input is simulated in
+// Win32 backend order (raw motion, then the cursor) with a click that starts
+// and ends within one frame every 30 frames.
+namespace
+{
+    struct Frame
+    {
+        MouseSample samples[MouseEventCodec::MAX_SAMPLES];
+        int count = 0;
+    };
+
+    std::vector<Frame> MakeFrames(int frameCount)
+    {
+        std::vector<Frame> frames(frameCount);
+        uint64_t timeNs = 1000000000ull;
+        Vector2i cursor(960, 540);
+        uint32_t seed = 12345;
+        for (int f = 0; f < frameCount; ++f)
+        {
+            Frame& frame = frames[f];
+            seed = seed * 1664525u + 1013904223u;
+            Vector2i motion(static_cast<int>(seed >> 28) - 8, static_cast<int>((seed >> 24) & 0xF) - 8);
+
+            MouseSample moved;
+            moved.timestampNs = timeNs + 2000000;
+            moved.position = cursor;
+            moved.movement = motion;
+            frame.samples[frame.count++] = moved;
+
+            cursor.x += motion.x;
+            cursor.y += motion.y;
+            MouseSample polled;
+            polled.timestampNs = timeNs + 2500000;
+            polled.position = cursor;
+            if (f % 120 == 0)
+                polled.wheelDelta = 120;
+            frame.samples[frame.count++] = polled;
+
+            if (f % 30 == 15)
+            {
+                MouseSample press = polled;
+                press.timestampNs = timeNs + 6000000;
+                press.wheelDelta = 0;
+                press.buttons = MOUSE_BUTTON_LEFT;
+                frame.samples[frame.count++] = press;
+
+                MouseSample release = press;
+                release.timestampNs = timeNs + 9000000;
+                release.buttons = 0;
+                frame.samples[frame.count++] = release;
+            }
+            timeNs += 16666667;
+        }
+        return frames;
+    }
+
+    // The removed MouseEventData payload: position and buttons at the end of
+    // the frame, movement and wheel summed over it
+    std::string BuildJSON(const Frame& frame)
+    {
+        const MouseSample& last = frame.samples[frame.count - 1];
+        Vector2i movement;
+        int wheelDelta = 0;
+        for (int i = 0; i < frame.count; ++i)
+        {
+            movement.x += frame.samples[i].movement.x;
+            movement.y += frame.samples[i].movement.y;
+            wheelDelta += frame.samples[i].wheelDelta;
+        }
+
+        auto button = [&](uint8_t bit) { return std::string((last.buttons & bit) ? "true" : "false"); };
+        std::string mouseData = "{";
+        mouseData += "\"position\":[" + std::to_string(last.position.x) + "," + std::to_string(last.position.y) + "],";
+        mouseData += "\"movement\":[" + std::to_string(movement.x) + "," + std::to_string(movement.y) + "],";
+        mouseData += "\"wheelDelta\":" + std::to_string(wheelDelta) + ",";
+        mouseData += "\"leftButton\":" + button(MOUSE_BUTTON_LEFT) + ",";
+        mouseData += "\"rightButton\":" + button(MOUSE_BUTTON_RIGHT) + ",";
+        mouseData += "\"middleButton\":" + button(MOUSE_BUTTON_MIDDLE) + ",";
+        mouseData += "\"xButton1\":" + button(MOUSE_BUTTON_X1) + ",";
+        mouseData += "\"xButton2\":" + button(MOUSE_BUTTON_X2);
+        mouseData += "}";
+        return mouseData;
+    }
+
+    bool ParseJSON(JSONDocument& document, const std::string& payload, MouseSample& state)
+    {
+        if (!document.Parse(payload))
+            return false;
+
+        JSONValue root = document.Root();
+        int pair[2] = {};
+        if (root["position"].GetInts(pair, 2) != 2)
+            return false;
+        state.position = Vector2i(pair[0], pair[1]);
+        if (root["movement"].GetInts(pair, 2) != 2)
+            return false;
+        state.movement = Vector2i(pair[0], pair[1]);
+        state.wheelDelta = root["wheelDelta"].AsInt();
+        state.buttons = (root["leftButton"].AsBool() ? MOUSE_BUTTON_LEFT : 0) |
+                        (root["rightButton"].AsBool() ? MOUSE_BUTTON_RIGHT : 0) |
+                        (root["middleButton"].AsBool() ? MOUSE_BUTTON_MIDDLE : 0) |
+                        (root["xButton1"].AsBool() ? MOUSE_BUTTON_X1 : 0) |
+                        (root["xButton2"].AsBool() ? MOUSE_BUTTON_X2 : 0);
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int frameCount = argc > 1 ? std::max(30, std::atoi(argv[1])) : 60000;
+    std::vector<Frame> frames = MakeFrames(frameCount);
+
+    // Payloads once up front, for sizes and the decode side
+    std::vector<std::string> jsonPayloads;
+    std::vector<std::string> binaryPayloads;
+    size_t jsonBytes = 0;
+    size_t binaryBytes = 0;
+    size_t samples = 0;
+    int clicksInJSON = 0;
+    int clicksInBinary = 0;
+    JSONDocument document;
+    for (const Frame& frame : frames)
+    {
+        jsonPayloads.push_back(BuildJSON(frame));
+        jsonBytes += jsonPayloads.back().size();
+
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(frame.samples, frame.count, packet);
+        binaryPayloads.emplace_back(reinterpret_cast<const char*>(packet), size);
+        binaryBytes += size;
+        samples += frame.count;
+
+        MouseSample state;
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int count = 0;
+        if (!ParseJSON(document, jsonPayloads.back(), state) ||
+            !MouseEventCodec::Decode(packet, size, decoded, count) || count != frame.count)
+        {
+            std::fprintf(stderr, "Payloads do not decode\n");
+            return 1;
+        }
+        if (state.buttons & MOUSE_BUTTON_LEFT)
+            ++clicksInJSON;
+        for (int i = 0; i < count; ++i)
+        {
+            if (decoded[i].buttons & MOUSE_BUTTON_LEFT)
+                ++clicksInBinary;
+        }
+    }
+
+    size_t index = 0;
+    auto nextFrame = [&]() -> size_t
+    {
+        size_t current = index;
+        index = index + 1 == frames.size() ? 0 : index + 1;
+        return current;
+    };
+
+    double jsonBuildNs = BenchUtil::MeasureNs(frameCount, [&]()
+    {
+        std::string payload = BuildJSON(frames[nextFrame()]);
+        BenchUtil::KeepAlive(payload);
+    });
+
+    // As SendMouseEventUpdate(): encode on the stack, copy into a payload
+    // buffer that keeps its capacity
+    std::string payload;
+    double binaryBuildNs = BenchUtil::MeasureNs(frameCount, [&]()
+    {
+        const Frame& frame = frames[nextFrame()];
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(frame.samples, frame.count, packet);
+        payload.assign(reinterpret_cast<const char*>(packet), size);
+        BenchUtil::KeepAlive(payload);
+    });
+
+    double jsonDecodeNs = BenchUtil::MeasureNs(frameCount, [&]()
+    {
+        MouseSample state;
+        bool parsed = ParseJSON(document, jsonPayloads[nextFrame()], state);
+        BenchUtil::KeepAlive(parsed);
+        BenchUtil::KeepAlive(state);
+    });
+
+    double binaryDecodeNs = BenchUtil::MeasureNs(frameCount, [&]()
+    {
+        const std::string& received = binaryPayloads[nextFrame()];
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int count = 0;
+        bool parsed = MouseEventCodec::Decode(reinterpret_cast<const uint8_t*>(received.data()), received.size(),
+                                              decoded, count);
+        BenchUtil::KeepAlive(parsed);
+        BenchUtil::KeepAlive(decoded);
+    });
+
+    const double header = sizeof(IPCProtocol::FrameHeader);
+    double jsonPerMessage = static_cast<double>(jsonBytes) / frameCount;
+    double binaryPerMessage = static_cast<double>(binaryBytes) / frameCount;
+    std::printf("%d frames at 60 Hz, %.2f samples/frame, %d sub-frame clicks\n",
+                frameCount, static_cast<double>(samples) / frameCount, (frameCount + 14) / 30);
+    std::printf("  %-8s %6.1f B/msg  %6.2f KB/s on the wire  build %7.1f ns/msg  decode %7.1f ns/msg  clicks seen %d\n",
+                "JSON", jsonPerMessage, (jsonPerMessage + header) * 60 / 1024, jsonBuildNs, jsonDecodeNs, clicksInJSON);
+    std::printf("  %-8s %6.1f B/msg  %6.2f KB/s on the wire  build %7.1f ns/msg  decode %7.1f ns/msg  clicks seen %d\n",
+                "binary", binaryPerMessage, (binaryPerMessage + header) * 60 / 1024, binaryBuildNs, binaryDecodeNs,
+                clicksInBinary);
+    return 0;
+}
\ No newline at end of file
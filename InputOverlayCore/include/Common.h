@@ -4,9 +4,17 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min / std::max usable
+#endif
 #include <windows.h>
 #include <dinput.h>
+#endif
 
 // Version and application info
 #define INPUT_OVERLAY_VERSION "Input Overlay v1.0.0"
@@ -32,6 +40,8 @@ struct Vector2i
     int y = 0;
     Vector2i() = default;
     Vector2i(int x, int y) : x(x), y(y) {}
+    bool operator==(const Vector2i& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const Vector2i& other) const { return !(*this == other); }
 };
 
 struct IntRect
@@ -42,6 +52,11 @@ struct IntRect
     int height = 0;
     IntRect() = default;
     IntRect(int left, int top, int width, int height) : left(left), top(top), width(width), height(height) {}
+    bool operator==(const IntRect& other) const
+    {
+        return left == other.left && top == other.top && width == other.width && height == other.height;
+    }
+    bool operator!=(const IntRect& other) const { return !(*this == other); }
 };
 
 struct Color
@@ -61,12 +76,24 @@ struct InputKey
     int hid = 0;
     int winvk = 0;
     int evdev = 0;
-    std::string id;
+    std::string_view id;    // Interned in the owning config's arena
+    uint8_t stateIndex = 0; // Resolved key state index (virtual key), 0 = unbound
+};
+
+// Sprite states, indexing SpriteInfo::states; same numbering as OverlayElement::wheelState
+enum SpriteState
+{
+    SPRITE_NORMAL = 0,
+    SPRITE_PRESSED,
+    SPRITE_UP,       // Wheel scrolled up
+    SPRITE_DOWN,     // Wheel scrolled down
+    SPRITE_STATE_COUNT
 };
 
 // Sprite information
 struct SpriteInfo
 {
+    // As written in the preset (and saved back that way)
     IntRect normal;
     IntRect pressed;
     IntRect up;      // For wheel scroll up
@@ -74,12 +101,27 @@ struct SpriteInfo
     bool hasPressedState = false;
     bool hasUpState = false;
     bool hasDownState = false;
+
+    // Every state resolved once at load, so drawing is a plain lookup
+    IntRect states[SPRITE_STATE_COUNT];
+
+    // Fills 'states'. A missing pressed rect is the normal one moved by the
+    // preset's pressed offset; missing wheel rects show the pressed state.
+    void ResolveStates(const Vector2i& defaultPressedOffset)
+    {
+        states[SPRITE_NORMAL] = normal;
+        states[SPRITE_PRESSED] = hasPressedState ? pressed :
+            IntRect(normal.left + defaultPressedOffset.x, normal.top + defaultPressedOffset.y,
+                    normal.width, normal.height);
+        states[SPRITE_UP] = hasUpState ? up : states[SPRITE_PRESSED];
+        states[SPRITE_DOWN] = hasDownState ? down : states[SPRITE_PRESSED];
+    }
 };
 
 // Cursor/movement information
 struct CursorInfo
 {
-    std::string mode; // "arrow", "dot", etc.
+    std::string_view mode; // "arrow", "dot", etc.; interned like ids
     int radius = 50; // For dot mode
     bool enabled = false;
 };
@@ -87,7 +129,7 @@ struct CursorInfo
 // Overlay element
 struct OverlayElement
 {
-    std::string id;
+    std::string_view id;    // Interned in the owning config's arena
     InputKey key;
     Vector2i position;
     SpriteInfo sprite;
@@ -98,29 +140,53 @@ struct OverlayElement
     CursorInfo cursor;
 };
 
+class ConfigArena;
+
 // Overlay configuration
 struct OverlayConfig
 {
+    std::shared_ptr<ConfigArena> arena; // Owns the element strings; shared by copies
     int version = 1;
     std::string textureFile;
     Vector2i textureSize;
     Vector2i canvasSize;
     Color backgroundColor = Color::Transparent;
     Vector2i defaultPressedOffset;
+    bool latchTaps = true;       // Show taps shorter than a frame for one frame
+    int minPressDurationMs = 0;  // Minimum time a pressed sprite stays visible
     std::vector<OverlayElement> elements;
+    std::vector<uint8_t> keyStateIndices; // elements[i].key.stateIndex, flat for per-frame gathers
+};
+
+// One element-level edit made by ConfigParser::ApplyPatch(), in the order applied
+struct ConfigChange
+{
+    enum class Kind
+    {
+        Update, // elements[index] changed in place
+        Add,    // Inserted at index; later elements moved up by one
+        Remove  // Erased from index; later elements moved down by one
+    };
+
+    Kind kind;
+    size_t index;
 };
 
-// Mouse event data structure
-struct MouseEventData
+// MouseSample::buttons
+const uint8_t MOUSE_BUTTON_LEFT = 1 << 0;
+const uint8_t MOUSE_BUTTON_RIGHT = 1 << 1;
+const uint8_t MOUSE_BUTTON_MIDDLE = 1 << 2;
+const uint8_t MOUSE_BUTTON_X1 = 1 << 3;
+const uint8_t MOUSE_BUTTON_X2 = 1 << 4;
+
+// Mouse state right after one input report
+struct MouseSample
 {
+    uint64_t timestampNs = 0;
     Vector2i position;
-    Vector2i movement;
-    int wheelDelta;
-    bool leftButton;
-    bool rightButton;
-    bool middleButton;
-    bool xButton1;
-    bool xButton2;
+    Vector2i movement; // Relative motion in this report
+    int wheelDelta = 0;
+    uint8_t buttons = 0; // MOUSE_BUTTON_* held
 };
 
 // IPC Message structure
@@ -128,6 +194,7 @@ struct IPCMessage
 {
     IPCMessageType type;
     int overlayId = 0;
+    uint32_t correlationId = 0; // Chosen by the sender of a request and echoed in its reply; 0 = none
     std::string data;
     bool noBorders = false;
     bool topMost = false;
@@ -135,4 +202,6 @@ struct IPCMessage
 
 // Global constants
 const std::string PIPE_NAME = "\\\\.\\pipe\\InputOverlayPipe";
+const std::string IPC_SOCKET_NAME = "InputOverlay.sock"; // Unix socket, see UnixSocketTransport
+const std::string INPUT_STATE_NAME = "InputOverlayState"; // Shared memory, see SharedInputState
 const int MAX_MESSAGE_SIZE = 4096;
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Common.h"
+#include <memory_resource>
+#include <unordered_set>
+
+// Per-overlay string storage for an OverlayConfig.
+// Element ids, key names and cursor modes are interned into one monotonic
+// arena: equal strings share a single copy, nothing is freed individually,
+// and all of an overlay's text is released in one step when the last config
+// holding the arena goes away. Interned views stay valid for that long.
+class ConfigArena
+{
+public:
+    // Sized for 'expectedStrings' distinct strings up front, so a parsed
+    // preset normally fits the first block
+    explicit ConfigArena(size_t expectedStrings = 0);
+
+    ConfigArena(const ConfigArena&) = delete;
+    ConfigArena& operator=(const ConfigArena&) = delete;
+
+    // The config's arena, created on first use
+    static ConfigArena& Of(OverlayConfig& config, size_t expectedStrings = 0);
+
+    std::string_view Intern(std::string_view text);
+
+    // Points the element's strings at copies in this arena; needed before an
+    // element moves to a config with a different arena
+    void Adopt(OverlayElement& element);
+
+    // Strings of removed or renamed elements stay in the arena. Once it has
+    // reserved more than twice what the config's elements need, their strings
+    // move to a fresh arena and the old one is released (when no other copy
+    // of the config holds it). Returns true if it did.
+    static bool Compact(OverlayConfig& config);
+
+    // Heap blocks taken by the arena and their total size
+    size_t GetBlockCount() const { return m_upstream.blockCount; }
+    size_t GetReservedBytes() const { return m_upstream.reservedBytes; }
+    size_t GetStringCount() const { return m_strings.size(); }
+
+private:
+    // Table node, bucket and an average id per distinct string
+    static const size_t BYTES_PER_STRING = 64;
+    static const size_t MIN_BLOCK_SIZE = 1024;
+
+    // Forwards to the default heap and counts what the arena asks for
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t blockCount = 0;
+        size_t reservedBytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    CountingResource m_upstream;
+    std::pmr::monotonic_buffer_resource m_arena;
+    std::pmr::unordered_set<std::string_view> m_strings; // Table lives in the arena too
+};
\ No newline at end of file
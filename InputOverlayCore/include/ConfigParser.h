@@ -1,55 +1,108 @@
 #pragma once
 
 #include "Common.h"
+#include "ConfigArena.h"
+#include "JSONDocument.h"
+#include "JSONWriter.h"
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 
-// Simple JSON parser for overlay configuration
-// This is a lightweight implementation focused on our specific schema
+// Overlay configuration loader.
+// The document is tokenized once into a JSONDocument; section parsers then
+// read fields by key from their own object, so nested or quoted keys never
+// match the wrong value.
 class ConfigParser
 {
 public:
     ConfigParser();
     ~ConfigParser();
 
+    // Both use a binary cache (PresetCache.h) when one matches the JSON text:
+    // files keep theirs beside the preset, strings use the cache directory.
     bool ParseConfigFromFile(const std::string& filePath, OverlayConfig& config);
-    bool ParseConfigFromJSON(const std::string& jsonString, OverlayConfig& config);
-    bool ParseFromString(const std::string& jsonString, OverlayConfig& config); // Alias for compatibility
+    bool ParseFromString(const std::string& jsonString, OverlayConfig& config);
+
+    // Always parses the JSON text, never touches a cache.
+    // Presets in the OBS input-overlay format are detected and imported.
+    // sourcePath locates "extends"/"include" files; without it they are
+    // relative to the working directory.
+    bool ParseConfigFromJSON(std::string_view jsonString, OverlayConfig& config, const std::string& sourcePath = "");
+
+    // Files the last parse read besides the preset itself (parents, includes)
+    const std::vector<std::string>& GetDependencies() const { return m_dependencies; }
+
+    // Directory for caches of configs that arrive as text (ADD_OVERLAY); empty disables
+    void SetCacheDirectory(const std::string& directory);
+    void SetCacheEnabled(bool enabled) { m_cacheEnabled = enabled; }
+
+    // Runs PresetValidator on every parse and prints its findings; presets with
+    // errors (wrong types, malformed rects) fail to load instead of falling back
+    // to defaults. The checks need the document, so the cache is not read;
+    // presets that pass still write it.
+    void SetStrictValidation(bool strict) { m_strictValidation = strict; }
+
+    // Writes the config in the native preset schema; parsing the output gives
+    // back the same config. Files are indented, ConfigToJSON is compact.
     bool SaveConfigToFile(const std::string& filePath, const OverlayConfig& config);
-    std::string ConfigToJSON(const OverlayConfig& config);
+    std::string ConfigToJSON(const OverlayConfig& config, bool pretty = false);
+    void WriteConfig(JSONWriter& writer, const OverlayConfig& config);
+
+    // Resolves every element's key binding into config.keyStateIndices
+    void ResolveKeyBindings(OverlayConfig& config);
+
+    // Edits a live config in place (UPDATE_OVERLAY). The patch is
+    //   { "ops": [ { "op": "update", "index": 3, "pos": [120, 0] },
+    //              { "op": "add", "index": 5, "id": "f", "codes": {...}, ... },
+    //              { "op": "remove", "id": "tab" } ] }
+    // Ops run in order. update/remove pick their element by "index" or by "id";
+    // add inserts at "index", or appends without one. The other fields use the
+    // element schema, and update only changes the fields it lists. Key bindings
+    // of touched elements are re-resolved. Every op that was applied is appended
+    // to 'changes'. Returns false if any op was rejected (the rest still apply).
+    // Strings of elements patched away are dropped by ConfigArena::Compact().
+    bool ApplyPatch(std::string_view patchJson, OverlayConfig& config, std::vector<ConfigChange>& changes);
 
 private:
-    // JSON parsing helpers
-    std::string Trim(const std::string& str);
-    std::string GetStringValue(const std::string& json, const std::string& key);
-    int GetIntValue(const std::string& json, const std::string& key);
-    std::vector<int> GetIntArray(const std::string& json, const std::string& key);
-    std::string GetObjectValue(const std::string& json, const std::string& key);
-    std::vector<std::string> GetArrayObjects(const std::string& json, const std::string& key);
+    JSONDocument m_document; // Reused between parses to keep its buffers
+    std::string m_cacheDirectory;
+    bool m_cacheEnabled;
+    bool m_strictValidation;
+
+    // Parsed parents and includes, shared by every preset that names them.
+    // An entry is used while none of its files changed on disk.
+    struct ComposedPart
+    {
+        OverlayConfig config;
+        std::vector<std::pair<std::string, std::filesystem::file_time_type>> files; // Itself first, then its own parts
+    };
+    std::map<std::string, ComposedPart> m_parts;
+    std::vector<std::string> m_dependencies;
+    std::vector<std::string> m_loading; // Parts being parsed, to catch cycles
+
+    // cachePath is the cache file when sourcePath is set, else the cache directory
+    bool ParseWithCache(std::string_view jsonString, const std::string& cachePath,
+                        const std::string& sourcePath, OverlayConfig& config);
 
     // Parsing specific sections
-    bool ParseTexture(const std::string& textureJson, OverlayConfig& config);
-    bool ParseCanvas(const std::string& canvasJson, OverlayConfig& config);
-    bool ParseDefaults(const std::string& defaultsJson, OverlayConfig& config);
-    bool ParseElements(const std::string& elementsJson, OverlayConfig& config);
-    bool ParseElement(const std::string& elementJson, OverlayElement& element);
-    bool ParseCodes(const std::string& codesJson, InputKey& key);
-    bool ParseSprite(const std::string& spriteJson, SpriteInfo& sprite, const Vector2i& defaultOffset);
-    bool ParseCursor(const std::string& cursorJson, CursorInfo& cursor);
+    bool ParseTexture(const JSONValue& texture, OverlayConfig& config);
+    bool ParseCanvas(const JSONValue& canvas, OverlayConfig& config);
+    bool ParseDefaults(const JSONValue& defaults, OverlayConfig& config);
+    bool ParseElements(const JSONValue& elements, OverlayConfig& config, size_t inheritedCount = 0);
+    bool ParseElement(const JSONValue& elementJson, OverlayElement& element, OverlayConfig& config);
+    bool ParseCodes(const JSONValue& codes, InputKey& key);
+    bool ParseSprite(const JSONValue& spriteJson, SpriteInfo& sprite);
+    bool ParseCursor(const JSONValue& cursorJson, CursorInfo& cursor, ConfigArena& arena);
+    bool FindPatchTarget(const JSONValue& op, const OverlayConfig& config, size_t& index);
 
-    // JSON generation helpers
-    std::string IntArrayToJSON(const std::vector<int>& arr);
-    std::string Vector2iToJSON(const Vector2i& vec);
-    std::string IntRectToJSON(const IntRect& rect);
-};
+    // Composition: fills 'config' with the parent and included elements named
+    // by 'root'. Leaves m_document holding the preset again.
+    bool ComposeParts(const JSONValue& root, const std::string& sourcePath, OverlayConfig& config);
+    const ComposedPart* LoadPart(const std::string& path);
 
-// Utility functions for JSON string manipulation
-namespace JSONUtils
-{
-    std::string ExtractValue(const std::string& json, const std::string& key);
-    std::string ExtractStringValue(const std::string& json, const std::string& key);
-    int ExtractIntValue(const std::string& json, const std::string& key);
-    std::vector<int> ExtractIntArray(const std::string& json, const std::string& key);
-    bool FindKeyValue(const std::string& json, const std::string& key, std::string& value);
-    std::vector<std::string> SplitArray(const std::string& arrayJson);
-}
\ No newline at end of file
+    // JSON generation helpers
+    void ElementToJSON(JSONWriter& writer, const OverlayElement& element);
+    void IntArrayToJSON(JSONWriter& writer, const std::vector<int>& arr);
+    void Vector2iToJSON(JSONWriter& writer, const Vector2i& vec);
+    void IntRectToJSON(JSONWriter& writer, const IntRect& rect);
+};
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "InputBackend.h"
+#include "MouseAccumulator.h"
+
+#ifdef __linux__
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Linux backend reading /dev/input/event* devices.
+// A capture thread blocks in epoll_wait and records every key/button edge with
+// the kernel timestamp and sums relative motion at device rate, so no input is
+// lost between frames.
+class EvdevInputBackend : public InputBackend
+{
+public:
+    EvdevInputBackend();
+    ~EvdevInputBackend() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+    const char* GetName() const override { return "evdev"; }
+    void Poll(std::vector<InputEvent>& events) override;
+
+private:
+    struct Device
+    {
+        int fd = -1;
+        uint16_t index = 0;
+        std::string path;
+        std::string name;
+    };
+
+    int m_epollFd;
+    int m_wakeFd; // eventfd used to stop the capture thread
+    std::vector<Device> m_devices;
+    std::atomic<bool> m_shouldStop;
+    std::thread m_captureThread;
+
+    // Events captured by the thread, handed over in Poll()
+    std::vector<InputEvent> m_capturedEvents;
+    std::mutex m_capturedMutex;
+    MouseAccumulator m_mouse;
+
+    bool OpenDevices();
+    bool OpenDevice(const std::string& path, uint16_t index);
+    void CloseDevice(Device& device);
+    void CaptureThreadFunc();
+    bool ReadDevice(Device& device, std::vector<InputEvent>& batch);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+
+// A watched file that changed on disk
+struct FileChange
+{
+    std::string path;     // FileWatcher::CanonicalPath() of the path passed to Watch()
+    uint64_t detectedNs;  // GetInputTimestampNs() when the change was seen
+};
+
+// Non-blocking change notification for individual files.
+// The containing directories are watched rather than the files, so editors
+// that save by writing a temporary file and renaming it over the original are
+// seen too. Linux uses inotify and reports a file once its writer closes it or
+// it is renamed into place; Windows uses FindFirstChangeNotification and
+// compares last-write times. A file is listed at most once per Poll().
+// Files are keyed by their canonical path, so every spelling of one file
+// ("x.json", "./dir/../x.json", a symlink) shares one entry.
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool Initialize();
+    void Shutdown();
+
+    // Reference counted: a file watched twice, under any spelling, needs two
+    // Unwatch() calls
+    bool Watch(const std::string& path);
+    void Unwatch(const std::string& path);
+
+    // Absolute path with ".", ".." and symlinks resolved as far as it exists
+    static std::string CanonicalPath(const std::string& path);
+
+    // Appends files changed since the previous call
+    void Poll(std::vector<FileChange>& changes);
+
+private:
+    struct WatchedFile
+    {
+        std::string path;        // Canonical
+        std::string name;        // File name within the directory
+        int refCount = 0;
+        uint64_t lastWrite = 0;  // Windows: last-write FILETIME
+    };
+
+    // Watched while any of its files is. On Linux there is one entry per
+    // inotify watch: a directory reached under another path shares it.
+    struct WatchedDirectory
+    {
+        std::string path;
+        std::vector<WatchedFile> files;
+#ifdef _WIN32
+        HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+        int wd = -1;
+#endif
+    };
+
+    std::vector<WatchedDirectory> m_directories;
+#ifndef _WIN32
+    int m_inotifyFd;
+#endif
+
+    static void SplitPath(const std::string& path, std::string& directory, std::string& name);
+    void RemoveDirectoryWatch(WatchedDirectory& directory);
+    static void AddChange(std::vector<FileChange>& changes, size_t firstNew, const std::string& path, uint64_t timestamp);
+};
\ No newline at end of file
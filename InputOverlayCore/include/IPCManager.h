@@ -1,34 +1,62 @@
 #pragma once
 
 #include "Common.h"
+#include "IPCTransport.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <queue>
 #include <mutex>
 #include <thread>
 
+// Queues IPCMessages between the main loop and the UI. A reader and a writer
+// thread move them over an IPCTransport (named pipe on Windows, Unix socket
+// on Linux) as IPCProtocol frames. Both threads block until there is
+// something to do (a message, a connection, or Shutdown()), so nothing waits
+// on a timer.
 class IPCManager
 {
 public:
     IPCManager();
     ~IPCManager();
 
-    bool Initialize();
+    // Uses the platform's default transport when none is given
+    bool Initialize(std::unique_ptr<IPCTransport> transport = nullptr);
     void Shutdown();
     void Cleanup(); // Add missing cleanup method
 
     bool SendMessage(const IPCMessage& message);
+    bool SendMessage(IPCMessage&& message);
+
+    // Answers a request that carries a correlation id with a STATUS_UPDATE
+    // holding the same id: "ok", or "error" when it was rejected. Requests
+    // without one get no reply.
+    void SendReply(const IPCMessage& request, bool succeeded);
+
+    // An empty string with the capacity of a payload the writer already sent,
+    // or a new one. A sender that fills it and queues its message by move
+    // (mouse events, every frame) stops allocating once a few have gone out.
+    std::string TakePayloadBuffer();
     bool ReceiveMessage(IPCMessage& message);
 
+    // Blocks until a message is waiting or 'deadline' passes; true if one is.
+    // Lets a frame loop sleep out its frame and still answer requests at once.
+    bool WaitForMessage(std::chrono::steady_clock::time_point deadline);
+
     bool IsConnected() const { return m_isConnected; }
 
 private:
-    HANDLE m_hPipe;
-    bool m_isConnected;
-    bool m_shouldStop;
+    std::unique_ptr<IPCTransport> m_transport;
+    std::atomic<bool> m_isConnected;
+    std::atomic<bool> m_shouldStop;
 
     std::queue<IPCMessage> m_incomingMessages;
-    std::queue<IPCMessage> m_outgoingMessages;
+    std::vector<IPCMessage> m_outgoingMessages; // Swapped with the writer's batch, so both keep their capacity
+    std::vector<std::string> m_spareBuffers;    // Payloads already sent, for TakePayloadBuffer()
     std::mutex m_incomingMutex;
+    std::condition_variable m_incomingReady; // Message received
     std::mutex m_outgoingMutex;
+    std::condition_variable m_outgoingReady; // Message queued, connection changed or stopping
 
     std::thread m_readerThread;
     std::thread m_writerThread;
@@ -37,29 +65,88 @@ private:
     void ReaderThreadFunc();
     void WriterThreadFunc();
 
-    // Message serialization
-    std::string SerializeMessage(const IPCMessage& message);
-    bool DeserializeMessage(const std::string& data, IPCMessage& message);
-
-    // Pipe operations
-    bool CreateNamedPipe();
-    bool ConnectToPipe();
-    void DisconnectPipe();
+    // Connection and stop changes are made under m_outgoingMutex, so the
+    // writer cannot miss one between checking and waiting
+    void SetConnected(bool connected);
 };
 
-// C# IPC Interface - will be implemented in C# side
+// Wire format of every IPC message in both directions. One transport
+// message carries one frame (little endian, 4-byte aligned):
+//   FrameHeader   headerSize bytes
+//   payload       payloadSize bytes of IPCMessage::data, from payloadOffset
+// Payloads larger than MAX_FRAME_PAYLOAD are split over consecutive frames
+// with the same header fields and increasing payloadOffset; the message is
+// complete once payloadOffset + payloadSize reaches messageSize.
+// VERSION changes only for incompatible layouts, and frames of another
+// version are rejected. Fields added later go after the ones below and are
+// skipped by older readers through headerSize.
 namespace IPCProtocol
 {
-    // Message format: [TYPE:4][ID:4][SIZE:4][DATA:SIZE]
-    const size_t HEADER_SIZE = 12;
+    const char MAGIC[2] = { 'I', 'O' };
+    const uint8_t VERSION = 1;
+
+    // Keeps every frame well inside what one pipe or socket message can
+    // carry; larger payloads are sent in pieces
+    const uint32_t MAX_FRAME_PAYLOAD = 64 * 1024;
+
+    // Largest payload a receiver will reassemble
+    const uint32_t MAX_MESSAGE_PAYLOAD = 16 * 1024 * 1024;
+
+    // FrameHeader::flags
+    const uint16_t FLAG_NO_BORDERS = 1 << 0;
+    const uint16_t FLAG_TOP_MOST = 1 << 1;
+
+    struct FrameHeader
+    {
+        char magic[2];
+        uint8_t version;
+        uint8_t type;           // IPCMessageType
+        uint16_t flags;
+        uint16_t headerSize;
+        uint32_t correlationId; // IPCMessage::correlationId
+        int32_t overlayId;
+        uint32_t messageSize;   // Whole payload across all frames
+        uint32_t payloadOffset; // Where this frame's payload goes in it
+        uint32_t payloadSize;
+    };
+
+    static_assert(sizeof(FrameHeader) == 28, "FrameHeader layout is part of the wire format");
 
-    struct MessageHeader
+    // A frame read in place: the payload points into the received buffer
+    struct FrameView
     {
-        uint32_t type;
-        uint32_t overlayId;
-        uint32_t dataSize;
+        FrameHeader header;
+        std::string_view payload;
     };
 
-    std::string EncodeMessage(const IPCMessage& message);
-    bool DecodeMessage(const std::string& buffer, IPCMessage& message);
+    // Appends the frame carrying message.data from 'offset' to 'out' and
+    // returns the number of payload bytes it took (at most MAX_FRAME_PAYLOAD).
+    // Reusing 'out' avoids allocating.
+    size_t EncodeFrame(const IPCMessage& message, size_t offset, std::string& out);
+
+    // Checks magic, version and sizes; false for anything malformed
+    bool ParseFrame(std::string_view frame, FrameView& view);
+
+    // Rebuilds messages from their frames. The payload is reserved at its
+    // full size from the first frame and each piece is copied into place
+    // once, straight from the receive buffer.
+    class MessageAssembler
+    {
+    public:
+        enum class Result
+        {
+            Incomplete, // More frames of this message to come
+            Complete,   // 'message' holds the whole message
+            Malformed   // Frame dropped, along with any partial message
+        };
+
+        Result Feed(std::string_view frame, IPCMessage& message);
+
+        // Forgets a partial message, e.g. when the peer disconnects
+        void Reset() { m_inProgress = false; }
+
+    private:
+        bool m_inProgress = false;
+        FrameHeader m_first = {}; // Header of the first frame of the message being rebuilt
+    };
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Common.h"
+
+// Message channel between the core and the UI, implemented per platform.
+// Every Write() arrives as exactly one Read() on the other end (message
+// pipes, SOCK_SEQPACKET), so an IPCProtocol frame needs no delimiting.
+//
+// The core is the server and talks to one client at a time. IPCManager calls
+// WaitForClient/Read on its reader thread and Write on its writer thread;
+// Shutdown may be called from any thread and makes every blocked call return;
+// the endpoint itself is released by the destructor, once those threads are done.
+class IPCTransport
+{
+public:
+    virtual ~IPCTransport() = default;
+
+    // Creates the endpoint (server) or connects to it (client)
+    virtual bool Initialize() = 0;
+    virtual void Shutdown() = 0;
+    virtual const char* GetName() const = 0;
+
+    // Blocks until a client is connected; false on shutdown or error.
+    // A client transport is connected once initialized.
+    virtual bool WaitForClient() = 0;
+
+    // Drops the current client; the next WaitForClient() accepts another
+    virtual void Disconnect() = 0;
+
+    // One whole message. False when the peer is gone or on shutdown.
+    virtual bool Read(std::string& message) = 0;
+    virtual bool Write(const std::string& message) = 0;
+};
+
+// Creates the server transport for the current platform
+std::unique_ptr<IPCTransport> CreateDefaultIPCTransport();
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Common.h"
+
+// Kind of input event delivered by a backend
+enum class InputEventType : uint8_t
+{
+    Key = 0,      // code = virtual key, value = 1 (down) or 0 (up)
+    Relative = 1, // code = InputAxis, value = delta
+    Absolute = 2  // code = InputAxis, value = absolute position
+};
+
+// Axis codes for Relative/Absolute events
+enum InputAxis
+{
+    INPUT_AXIS_X = 0,
+    INPUT_AXIS_Y = 1,
+    INPUT_AXIS_WHEEL = 2 // In WHEEL_DELTA units (120 per notch)
+};
+
+// Single timestamped input event
+struct InputEvent
+{
+    uint64_t timestampNs = 0; // Monotonic clock, see GetInputTimestampNs()
+    InputEventType type = InputEventType::Key;
+    uint16_t device = 0;
+    int code = 0;
+    int value = 0;
+};
+
+// Monotonic timestamp in nanoseconds, same clock as InputEvent::timestampNs
+uint64_t GetInputTimestampNs();
+
+// Interface implemented by every platform input source.
+// Backends capture input edges as they happen and hand them over in Poll().
+class InputBackend
+{
+public:
+    virtual ~InputBackend() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Shutdown() = 0;
+    virtual const char* GetName() const = 0;
+
+    // Append all events captured since the previous call to 'events'
+    virtual void Poll(std::vector<InputEvent>& events) = 0;
+
+    // Clock the event timestamps are measured against. Live backends use the
+    // system clock; replay may run on a virtual one.
+    virtual uint64_t GetTimeNs() const { return GetInputTimestampNs(); }
+};
+
+// Creates the native backend for the current platform
+std::unique_ptr<InputBackend> CreateDefaultInputBackend();
\ No newline at end of file
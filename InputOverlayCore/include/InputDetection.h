@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Common.h"
+#include "InputBackend.h"
+#include "KeyState.h"
+#include "InputJournal.h"
+#include "MouseEventCodec.h"
+
+class InputRecorder;
 
 class InputDetection
 {
@@ -9,97 +15,68 @@ public:
     ~InputDetection();
 
     bool Initialize();
+    bool Initialize(std::unique_ptr<InputBackend> backend);
     void Shutdown();
     void Update();
 
     bool IsKeyPressed(const InputKey& key);
+
+    // Sets elements[i].isPressed for this frame. With config.latchTaps a key that
+    // went down and up again since the previous Update() still reads as pressed,
+    // and config.minPressDurationMs keeps it visible for at least that long
+    // after its last down edge.
+    void UpdateElementStates(OverlayConfig& config) const;
+    bool IsKeyCodePressed(int virtualKey) const { return m_keyStates.Test(virtualKey); }
+    const KeyStateSet& GetKeyStates() const { return m_keyStates; }
+    KeyStateSet GetPressedKeys() const { return KeyStateSet::Pressed(m_previousKeyStates, m_keyStates); }
+    KeyStateSet GetReleasedKeys() const { return KeyStateSet::Released(m_previousKeyStates, m_keyStates); }
+
+    // Keys with a down edge since the previous Update(), even if already released
+    const KeyStateSet& GetLatchedKeys() const { return m_latchedKeys; }
+
+    // GetInputTimestampNs() at the last Update(), not earlier than any event it applied
+    uint64_t GetFrameTimeNs() const { return m_frameTimeNs; }
+
+    // Timestamped history of every key/button edge; read with an InputJournalReader
+    const InputJournal& GetJournal() const { return m_journal; }
+
+    // Writes every event the backend delivers to an .aiorec file (see InputRecording.h)
+    bool StartRecording(const std::string& filePath);
+    void StopRecording();
+    bool IsRecording() const { return m_recorder != nullptr; }
+
     bool IsMouseButtonPressed(int button);
     Vector2i GetMousePosition();
     Vector2i GetMouseMovement();
     int GetMouseWheelDelta();
+
+    // Mouse state after each mouse report of the last Update(), oldest first,
+    // so a click shorter than a frame still shows up
+    const MouseSample* GetMouseSamples() const { return m_mouseSamples; }
+    int GetMouseSampleCount() const { return m_mouseSampleCount; }
+
     void Cleanup(); // Add missing cleanup method
 
 private:
-    // DirectInput for mouse
-    LPDIRECTINPUT8 m_pDirectInput;
-    LPDIRECTINPUTDEVICE8 m_pMouseDevice;
-    DIMOUSESTATE m_mouseState;
-    HINSTANCE m_hInstance;
+    std::unique_ptr<InputBackend> m_backend;
+    std::vector<InputEvent> m_pendingEvents;
+    InputJournal m_journal;
+    std::unique_ptr<InputRecorder> m_recorder;
 
     // State tracking
-    std::map<int, bool> m_keyStates;
-    std::map<int, bool> m_previousKeyStates;
+    KeyStateSet m_keyStates;
+    KeyStateSet m_previousKeyStates;
+    KeyStateSet m_latchedKeys;
+    uint64_t m_lastDownNs[KeyStateSet::KEY_COUNT]; // Timestamp of each key's last down edge
+    uint64_t m_frameTimeNs;                        // Time of the last Update()
     Vector2i m_mousePosition;
-    Vector2i m_previousMousePosition;
     Vector2i m_mouseMovement;
     int m_mouseWheelDelta;
-    int m_previousWheelDelta;
+    bool m_hasAbsolutePosition;
+    MouseSample m_mouseSamples[MouseEventCodec::MAX_SAMPLES];
+    int m_mouseSampleCount;
 
     // Private methods
-    bool InitializeDirectInput();
-    bool InitializeMouse();
-    void UpdateKeyboardInput();
-    void UpdateMouseInput();
-    int ConvertHIDToVirtualKey(int hidCode);
-    int ConvertEvdevToVirtualKey(int evdevCode);
-};
-
-// HID to Virtual Key conversion table (partial)
-struct HIDToVKMapping
-{
-    int hid;
-    int vk;
-};
-
-// Common HID mappings
-const HIDToVKMapping HID_VK_TABLE[] = {
-    {4, 'A'},   // HID_KEYBOARD_A
-    {5, 'B'},   // HID_KEYBOARD_B
-    {6, 'C'},   // HID_KEYBOARD_C
-    {7, 'D'},   // HID_KEYBOARD_D
-    {8, 'E'},   // HID_KEYBOARD_E
-    {9, 'F'},   // HID_KEYBOARD_F
-    {10, 'G'},  // HID_KEYBOARD_G
-    {11, 'H'},  // HID_KEYBOARD_H
-    {12, 'I'},  // HID_KEYBOARD_I
-    {13, 'J'},  // HID_KEYBOARD_J
-    {14, 'K'},  // HID_KEYBOARD_K
-    {15, 'L'},  // HID_KEYBOARD_L
-    {16, 'M'},  // HID_KEYBOARD_M
-    {17, 'N'},  // HID_KEYBOARD_N
-    {18, 'O'},  // HID_KEYBOARD_O
-    {19, 'P'},  // HID_KEYBOARD_P
-    {20, 'Q'},  // HID_KEYBOARD_Q
-    {21, 'R'},  // HID_KEYBOARD_R
-    {22, 'S'},  // HID_KEYBOARD_S
-    {23, 'T'},  // HID_KEYBOARD_T
-    {24, 'U'},  // HID_KEYBOARD_U
-    {25, 'V'},  // HID_KEYBOARD_V
-    {26, 'W'},  // HID_KEYBOARD_W
-    {27, 'X'},  // HID_KEYBOARD_X
-    {28, 'Y'},  // HID_KEYBOARD_Y
-    {29, 'Z'},  // HID_KEYBOARD_Z
-    {30, '1'},  // HID_KEYBOARD_1
-    {31, '2'},  // HID_KEYBOARD_2
-    {32, '3'},  // HID_KEYBOARD_3
-    {33, '4'},  // HID_KEYBOARD_4
-    {34, '5'},  // HID_KEYBOARD_5
-    {35, '6'},  // HID_KEYBOARD_6
-    {36, '7'},  // HID_KEYBOARD_7
-    {37, '8'},  // HID_KEYBOARD_8
-    {38, '9'},  // HID_KEYBOARD_9
-    {39, '0'},  // HID_KEYBOARD_0
-    {40, VK_RETURN},    // HID_KEYBOARD_ENTER
-    {41, VK_ESCAPE},    // HID_KEYBOARD_ESCAPE
-    {42, VK_BACK},      // HID_KEYBOARD_BACKSPACE
-    {43, VK_TAB},       // HID_KEYBOARD_TAB
-    {44, VK_SPACE},     // HID_KEYBOARD_SPACE
-    {79, VK_RIGHT},     // HID_KEYBOARD_RIGHT_ARROW
-    {80, VK_LEFT},      // HID_KEYBOARD_LEFT_ARROW
-    {81, VK_DOWN},      // HID_KEYBOARD_DOWN_ARROW
-    {82, VK_UP},        // HID_KEYBOARD_UP_ARROW
-    {224, VK_LCONTROL}, // HID_KEYBOARD_LEFT_CONTROL
-    {225, VK_LSHIFT},   // HID_KEYBOARD_LEFT_SHIFT
-    {226, VK_LMENU},    // HID_KEYBOARD_LEFT_ALT
-    {0, 0} // End marker
+    void ApplyEvent(const InputEvent& event);
+    void AddMouseSample(uint64_t timestampNs, Vector2i movement, int wheelDelta);
 };
\ No newline at end of file
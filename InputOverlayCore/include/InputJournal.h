@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+
+// One key/button edge, as InputJournalReader delivers it
+struct InputRecord
+{
+    uint64_t timestampNs; // Same clock as GetInputTimestampNs()
+    uint16_t code;        // Virtual key / key state index
+    uint16_t device;      // Backend device index
+    uint8_t down;         // 1 = pressed, 0 = released
+    uint8_t reserved[3];
+};
+
+// Fixed-capacity, single-producer ring of input edges.
+// The capture path appends; any number of consumers (the shared input state,
+// stats) read from their own cursor without locking. Storage is allocated
+// once in the constructor.
+//
+// Slots are relaxed 32-bit atomics, like SharedInputState's words, so a
+// reader racing the producer is well defined; it copies records out and then
+// checks with IsIntact() that the producer did not lap it meanwhile.
+// A consumer that falls more than Capacity() records behind loses the oldest
+// records; InputJournalReader skips ahead and counts them as dropped.
+class InputJournal
+{
+public:
+    explicit InputJournal(size_t capacity = 4096); // Rounded up to a power of two
+    ~InputJournal();
+
+    InputJournal(const InputJournal&) = delete;
+    InputJournal& operator=(const InputJournal&) = delete;
+
+    // Producer side, single thread only
+    void Append(uint64_t timestampNs, int code, bool down, uint16_t device)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[head & m_mask];
+
+        // A reader that sees any word of this write then also sees the head
+        // that made the slot reusable, so its IsIntact() check fails
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.words[0].store(static_cast<uint32_t>(timestampNs), std::memory_order_relaxed);
+        slot.words[1].store(static_cast<uint32_t>(timestampNs >> 32), std::memory_order_relaxed);
+        slot.words[2].store(static_cast<uint16_t>(code) | (static_cast<uint32_t>(device) << 16), std::memory_order_relaxed);
+        slot.words[3].store(down ? 1 : 0, std::memory_order_relaxed);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    // Sequence number of the next record to be written
+    uint64_t GetHead() const { return m_head.load(std::memory_order_acquire); }
+    size_t Capacity() const { return m_mask + 1; }
+
+    // Oldest sequence number that can still be read. Its predecessor's slot
+    // belongs to the next Append(), matching IsIntact().
+    uint64_t GetTail() const
+    {
+        uint64_t head = GetHead();
+        return head >= Capacity() ? head - Capacity() + 1 : 0;
+    }
+
+    // Copies up to 'maxCount' records from 'cursor' on (stopping at the head)
+    // into 'records' and returns how many. 'cursor' must be >= GetTail(); the
+    // copies are only valid if IsIntact(cursor) holds afterwards.
+    size_t Copy(uint64_t cursor, InputRecord* records, size_t maxCount) const;
+
+    // True if records from 'cursor' onwards were not overwritten while being read
+    bool IsIntact(uint64_t cursor) const;
+
+private:
+    // One InputRecord: timestamp low and high word, code | device << 16, down
+    struct Slot
+    {
+        std::atomic<uint32_t> words[4];
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Journal slots need plain 32-bit loads and stores");
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+    std::atomic<uint64_t> m_head;
+};
+
+// Per-consumer read position into an InputJournal
+class InputJournalReader
+{
+public:
+    // Starts at the current head, i.e. only sees records appended from now on
+    explicit InputJournalReader(const InputJournal& journal)
+        : m_journal(journal)
+        , m_cursor(journal.GetHead())
+        , m_dropped(0)
+        , m_overruns(0)
+    {
+    }
+
+    // Calls fn(const InputRecord&) for every record not yet seen and returns
+    // the number delivered. Records are copied out in small batches and only
+    // delivered once checked intact; a batch the producer overwrote while it
+    // was copied is counted in GetOverruns() and its records as dropped.
+    template <typename Fn>
+    size_t Read(Fn fn)
+    {
+        InputRecord batch[BATCH_SIZE];
+        size_t delivered = 0;
+        while (true)
+        {
+            SkipOverwritten();
+
+            size_t count = m_journal.Copy(m_cursor, batch, BATCH_SIZE);
+            if (count == 0)
+                break;
+
+            // If the producer lapped us mid-copy the next pass skips ahead
+            if (!m_journal.IsIntact(m_cursor))
+            {
+                ++m_overruns;
+                continue;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                fn(batch[i]);
+            }
+
+            m_cursor += count;
+            delivered += count;
+        }
+        return delivered;
+    }
+
+    // Number of pending records
+    size_t Available() const { return static_cast<size_t>(m_journal.GetHead() - m_cursor); }
+
+    uint64_t GetCursor() const { return m_cursor; }
+    uint64_t GetDropped() const { return m_dropped; }
+    uint64_t GetOverruns() const { return m_overruns; }
+
+private:
+    static const size_t BATCH_SIZE = 64;
+
+    const InputJournal& m_journal;
+    uint64_t m_cursor;
+    uint64_t m_dropped;
+    uint64_t m_overruns;
+
+    void SkipOverwritten()
+    {
+        uint64_t tail = m_journal.GetTail();
+        if (m_cursor < tail)
+        {
+            m_dropped += tail - m_cursor;
+            m_cursor = tail;
+        }
+    }
+};
\ No newline at end of file
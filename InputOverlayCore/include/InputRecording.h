@@ -0,0 +1,106 @@
+#pragma once
+
+#include "InputBackend.h"
+#include "MappedFile.h"
+#include <fstream>
+
+// .aiorec input recordings
+//
+// Layout (little endian):
+//   header  "AIOR" | uint16 version | uint16 header size | uint64 start timestamp (ns)
+//   records varint  time since previous record (ns)
+//           uint8   tag: bits 0-1 InputEventType, bit 2 device index follows
+//           varint  device (only if tagged)
+//           varint  code
+//           varint  value, zigzag encoded
+//
+// A key edge on device 0 less than 0.27 s after the previous record takes 4-7 bytes.
+// Timestamps never go backwards; an event older than its predecessor is stored
+// with a zero delta.
+namespace InputRecording
+{
+    const char MAGIC[4] = { 'A', 'I', 'O', 'R' };
+    const uint16_t VERSION = 1;
+    const size_t HEADER_SIZE = 16;
+    const size_t MAX_RECORD_SIZE = 10 + 1 + 3 + 5 + 5;
+
+    // Writes one record to 'out' (at least MAX_RECORD_SIZE bytes) and returns its length
+    size_t EncodeEvent(const InputEvent& event, uint64_t previousTimestampNs, uint8_t* out);
+
+    // Reads one record at 'cursor' and advances it. Returns false on truncated or
+    // malformed data. event.timestampNs is previousTimestampNs plus the stored delta.
+    bool DecodeEvent(const uint8_t*& cursor, const uint8_t* end, uint64_t previousTimestampNs, InputEvent& event);
+}
+
+// Appends the event stream to an .aiorec file
+class InputRecorder
+{
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool Open(const std::string& filePath);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    void Record(const InputEvent& event);
+    void Record(const std::vector<InputEvent>& events);
+
+    uint64_t GetEventCount() const { return m_eventCount; }
+
+private:
+    std::ofstream m_file;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_previousTimestampNs;
+    uint64_t m_eventCount;
+
+    void Flush();
+};
+
+enum class ReplayMode
+{
+    Realtime, // Events are delivered when their recorded time has elapsed
+    Fast      // Every Poll() advances a virtual clock by one frame step
+};
+
+// Plays back an .aiorec file as an input source.
+// The file is memory mapped and decoded in place. In Fast mode the result is
+// independent of wall-clock time, so two runs over the same recording see the
+// same events in the same Update() calls.
+class ReplayInputBackend : public InputBackend
+{
+public:
+    explicit ReplayInputBackend(const std::string& filePath,
+                                ReplayMode mode = ReplayMode::Realtime,
+                                uint64_t frameStepNs = 16666667);
+    ~ReplayInputBackend() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+    const char* GetName() const override { return "replay"; }
+    void Poll(std::vector<InputEvent>& events) override;
+    uint64_t GetTimeNs() const override;
+
+    bool IsFinished() const { return !m_hasNextEvent && m_cursor == m_end; }
+    uint64_t GetEventCount() const { return m_eventCount; }
+
+private:
+    std::string m_filePath;
+    ReplayMode m_mode;
+    uint64_t m_frameStepNs;
+    MappedFile m_file;
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    uint64_t m_recordStartNs;     // Start timestamp from the header
+    uint64_t m_previousTimestampNs;
+    uint64_t m_playbackStartNs;   // Realtime: wall clock at Initialize()
+    uint64_t m_virtualTimeNs;     // Fast: current position in recording time
+    uint64_t m_eventCount;
+
+    // Decoded but not yet due
+    InputEvent m_nextEvent;
+    bool m_hasNextEvent;
+
+    bool DecodeNext();
+};
\ No newline at end of file
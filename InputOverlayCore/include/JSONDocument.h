@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Common.h"
+#include <string_view>
+
+enum class JSONType : uint8_t
+{
+    Invalid = 0, // Missing member / out-of-range index
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+class JSONDocument;
+
+// Lightweight handle to a node of a parsed JSONDocument.
+// Copy freely; valid as long as the document is alive and not re-parsed.
+class JSONValue
+{
+public:
+    JSONValue() : m_document(nullptr), m_index(0) {}
+    JSONValue(const JSONDocument* document, uint32_t index) : m_document(document), m_index(index) {}
+
+    JSONType GetType() const;
+    bool IsValid() const { return GetType() != JSONType::Invalid; }
+    bool IsNull() const { return GetType() == JSONType::Null; }
+    bool IsBool() const { return GetType() == JSONType::Bool; }
+    bool IsNumber() const { return GetType() == JSONType::Number; }
+    bool IsString() const { return GetType() == JSONType::String; }
+    bool IsArray() const { return GetType() == JSONType::Array; }
+    bool IsObject() const { return GetType() == JSONType::Object; }
+    bool IsInteger() const; // Number without fraction or exponent that fits int64
+    bool FitsInt() const;   // Number whose integer part fits an int
+
+    // Typed access; return 'fallback' if the value has a different type.
+    // AsInt() truncates fractions and also falls back when !FitsInt().
+    bool AsBool(bool fallback = false) const;
+    int AsInt(int fallback = 0) const;
+    double AsDouble(double fallback = 0.0) const;
+    std::string_view AsStringView() const; // Unescaped text, empty if not a string
+    std::string AsString(const std::string& fallback = "") const;
+
+    // Object member lookup, Invalid if missing or not an object
+    JSONValue operator[](std::string_view key) const;
+    JSONValue operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+    bool HasMember(std::string_view key) const { return (*this)[key].IsValid(); }
+
+    // Array element / object member count
+    size_t Size() const;
+
+    // Array element by index (linear walk), Invalid if out of range
+    JSONValue At(size_t index) const;
+
+    // Reads up to 'count' integers from an array into 'out'; returns how many were read.
+    // Stops at the first item that is not a number fitting an int, so a short or
+    // malformed array returns less than 'count'.
+    size_t GetInts(int* out, size_t count) const;
+
+    // Byte offset of this value in the source text, for diagnostics
+    size_t GetOffset() const;
+
+    // Iterates children in document order: array elements, or object member values
+    class Iterator
+    {
+    public:
+        Iterator(const JSONDocument* document, uint32_t index, bool object)
+            : m_document(document), m_index(index), m_object(object) {}
+
+        JSONValue operator*() const;
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+        // Member name when iterating an object
+        std::string_view Key() const;
+
+    private:
+        const JSONDocument* m_document;
+        uint32_t m_index;  // Array element, or member key for objects
+        bool m_object;
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    const JSONDocument* m_document;
+    uint32_t m_index;
+};
+
+// Single-pass JSON parser producing a flat node tape.
+// Every value is one 24-byte node in a contiguous vector; containers store the
+// index one past their last descendant, so skipping a subtree is O(1) and
+// member lookup never rescans text. Strings reference the source buffer and
+// are only copied when they contain escapes. Strict RFC 8259 syntax.
+class JSONDocument
+{
+public:
+    JSONDocument();
+
+    // 'text' is copied into the document, the caller's buffer may go away.
+    // On failure Root() is Invalid and GetError() describes the first problem.
+    bool Parse(std::string_view text);
+
+    JSONValue Root() const { return m_nodes.empty() ? JSONValue() : JSONValue(this, 0); }
+
+    // First error of the last Parse() call
+    const std::string& GetError() const { return m_error; }
+    size_t GetErrorOffset() const { return m_errorOffset; }
+
+    // 1-based line and column of a byte offset in the source text
+    void GetLineColumn(size_t offset, int& line, int& column) const;
+
+private:
+    friend class JSONValue;
+
+    static const uint8_t NODE_ESCAPED = 1; // String lives in m_unescaped instead of m_text
+    static const uint8_t NODE_INTEGER = 2; // Number fits int64 exactly
+
+    struct Node
+    {
+        JSONType type;
+        uint8_t flags;     // NODE_ESCAPED, NODE_INTEGER
+        uint16_t reserved;
+        uint32_t end;      // Index one past this node's subtree
+        uint32_t offset;   // Source offset (strings: first char after the quote)
+        uint32_t length;   // String length, or element/member count for containers
+        union
+        {
+            int64_t integer; // Number with NODE_INTEGER; m_unescaped offset for NODE_ESCAPED strings
+            double real;
+            bool boolean;
+        };
+    };
+
+    std::string m_text;
+    std::string m_unescaped;
+    std::vector<Node> m_nodes;
+    std::string m_error;
+    size_t m_errorOffset;
+
+    // Parser state
+    size_t m_pos;
+    int m_depth;
+
+    bool ParseValue();
+    bool ParseObject();
+    bool ParseArray();
+    bool ParseString();
+    bool ParseNumber();
+    bool ParseLiteral(const char* literal, JSONType type, bool value);
+    bool ParseHexQuad(uint32_t& codePoint);
+    void SkipWhitespace();
+    bool Fail(const char* message);
+
+    std::string_view StringAt(uint32_t index) const;
+    uint32_t FindMember(uint32_t objectIndex, std::string_view key) const;
+};
\ No newline at end of file
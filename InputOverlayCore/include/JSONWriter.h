@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Common.h"
+#include <ostream>
+#include <string_view>
+
+// Streaming JSON writer.
+// Values are formatted in place at the end of one output buffer: each call
+// reserves its worst-case size once and writes through a raw pointer, and
+// numbers use std::to_chars, so no temporary strings are created. The buffer
+// grows geometrically; the target string only has its final length after
+// Flush() or destruction. In stream mode the buffer is written out whenever
+// it passes 'flushThreshold' bytes, and by Flush() / the destructor.
+//
+// The writer only tracks commas and indentation; the caller is responsible
+// for balanced Begin/End calls and for a Key() before each object member.
+class JSONWriter
+{
+public:
+    // Appends to 'out'
+    explicit JSONWriter(std::string& out, bool pretty = false);
+
+    // Buffers and writes to 'stream'
+    JSONWriter(std::ostream& stream, bool pretty = false, size_t flushThreshold = 64 * 1024);
+    ~JSONWriter();
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    void Key(std::string_view key);
+    void String(std::string_view value);
+    void Int(int64_t value);
+    void Bool(bool value);
+    void Null();
+
+    // Array of integers on a single line, also in pretty mode: [1, 2, 3]
+    void IntArray(const int* values, size_t count);
+
+    // Trims the target string to the output, or writes buffered output to the
+    // stream; returns false if the stream failed
+    bool Flush();
+
+private:
+    static const int MAX_DEPTH = 64;
+    static const size_t MAX_INT_CHARS = 20; // "-9223372036854775808"
+
+    std::string* m_out;         // Target string, or m_buffer in stream mode
+    size_t m_size;              // Bytes of m_out written so far
+    std::string m_buffer;
+    std::ostream* m_stream;
+    size_t m_flushThreshold;
+    bool m_pretty;
+
+    int m_depth;
+    uint64_t m_hasMembers;      // Bit per depth: container already has a value
+    bool m_afterKey;            // Next value completes an object member
+
+    // Room for 'count' more bytes at m_out->data() + m_size
+    char* Reserve(size_t count);
+    void Append(const char* text, size_t length);
+
+    uint64_t DepthBit() const;
+    void BeginValue();
+    void BeginContainer(char open);
+    void EndContainer(char close);
+};
\ No newline at end of file
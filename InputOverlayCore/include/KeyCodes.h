@@ -0,0 +1,488 @@
+#pragma once
+
+#include "Common.h"
+
+// Virtual key codes used by the core. On Windows these come from <windows.h>;
+// other platforms get the same numeric values so key states share one code space.
+#ifndef _WIN32
+#define VK_LBUTTON             0x01
+#define VK_RBUTTON             0x02
+#define VK_CANCEL              0x03
+#define VK_MBUTTON             0x04
+#define VK_XBUTTON1            0x05
+#define VK_XBUTTON2            0x06
+#define VK_BACK                0x08
+#define VK_TAB                 0x09
+#define VK_CLEAR               0x0C
+#define VK_RETURN              0x0D
+#define VK_SHIFT               0x10
+#define VK_CONTROL             0x11
+#define VK_MENU                0x12
+#define VK_PAUSE               0x13
+#define VK_CAPITAL             0x14
+#define VK_ESCAPE              0x1B
+#define VK_SPACE               0x20
+#define VK_PRIOR               0x21
+#define VK_NEXT                0x22
+#define VK_END                 0x23
+#define VK_HOME                0x24
+#define VK_LEFT                0x25
+#define VK_UP                  0x26
+#define VK_RIGHT               0x27
+#define VK_DOWN                0x28
+#define VK_SELECT              0x29
+#define VK_PRINT               0x2A
+#define VK_EXECUTE             0x2B
+#define VK_SNAPSHOT            0x2C
+#define VK_INSERT              0x2D
+#define VK_DELETE              0x2E
+#define VK_HELP                0x2F
+#define VK_LWIN                0x5B
+#define VK_RWIN                0x5C
+#define VK_APPS                0x5D
+#define VK_SLEEP               0x5F
+#define VK_NUMPAD0             0x60
+#define VK_NUMPAD1             0x61
+#define VK_NUMPAD2             0x62
+#define VK_NUMPAD3             0x63
+#define VK_NUMPAD4             0x64
+#define VK_NUMPAD5             0x65
+#define VK_NUMPAD6             0x66
+#define VK_NUMPAD7             0x67
+#define VK_NUMPAD8             0x68
+#define VK_NUMPAD9             0x69
+#define VK_MULTIPLY            0x6A
+#define VK_ADD                 0x6B
+#define VK_SEPARATOR           0x6C
+#define VK_SUBTRACT            0x6D
+#define VK_DECIMAL             0x6E
+#define VK_DIVIDE              0x6F
+#define VK_F1                  0x70
+#define VK_F2                  0x71
+#define VK_F3                  0x72
+#define VK_F4                  0x73
+#define VK_F5                  0x74
+#define VK_F6                  0x75
+#define VK_F7                  0x76
+#define VK_F8                  0x77
+#define VK_F9                  0x78
+#define VK_F10                 0x79
+#define VK_F11                 0x7A
+#define VK_F12                 0x7B
+#define VK_F13                 0x7C
+#define VK_F14                 0x7D
+#define VK_F15                 0x7E
+#define VK_F16                 0x7F
+#define VK_F17                 0x80
+#define VK_F18                 0x81
+#define VK_F19                 0x82
+#define VK_F20                 0x83
+#define VK_F21                 0x84
+#define VK_F22                 0x85
+#define VK_F23                 0x86
+#define VK_F24                 0x87
+#define VK_NUMLOCK             0x90
+#define VK_SCROLL              0x91
+#define VK_LSHIFT              0xA0
+#define VK_RSHIFT              0xA1
+#define VK_LCONTROL            0xA2
+#define VK_RCONTROL            0xA3
+#define VK_LMENU               0xA4
+#define VK_RMENU               0xA5
+#define VK_BROWSER_BACK        0xA6
+#define VK_BROWSER_FORWARD     0xA7
+#define VK_BROWSER_REFRESH     0xA8
+#define VK_BROWSER_STOP        0xA9
+#define VK_BROWSER_SEARCH      0xAA
+#define VK_BROWSER_FAVORITES   0xAB
+#define VK_BROWSER_HOME        0xAC
+#define VK_VOLUME_MUTE         0xAD
+#define VK_VOLUME_DOWN         0xAE
+#define VK_VOLUME_UP           0xAF
+#define VK_MEDIA_NEXT_TRACK    0xB0
+#define VK_MEDIA_PREV_TRACK    0xB1
+#define VK_MEDIA_STOP          0xB2
+#define VK_MEDIA_PLAY_PAUSE    0xB3
+#define VK_LAUNCH_MAIL         0xB4
+#define VK_LAUNCH_MEDIA_SELECT 0xB5
+#define VK_LAUNCH_APP1         0xB6
+#define VK_LAUNCH_APP2         0xB7
+#define VK_OEM_1               0xBA
+#define VK_OEM_PLUS            0xBB
+#define VK_OEM_COMMA           0xBC
+#define VK_OEM_MINUS           0xBD
+#define VK_OEM_PERIOD          0xBE
+#define VK_OEM_2               0xBF
+#define VK_OEM_3               0xC0
+#define VK_OEM_4               0xDB
+#define VK_OEM_5               0xDC
+#define VK_OEM_6               0xDD
+#define VK_OEM_7               0xDE
+#define VK_OEM_8               0xDF
+#define VK_OEM_102             0xE2
+#endif
+
+// Key code translation between HID keyboard usages (page 0x07), Linux evdev
+// codes, Windows virtual keys and set-1 scancodes (0xE0xx for extended keys).
+// All lookup tables are generated from KEY_CODE_TABLE at compile time and are
+// indexed directly by code, so no lookup ever searches.
+namespace KeyCodes
+{
+    struct KeyCodeEntry
+    {
+        uint8_t hid;       // HID usage, 0 if the key has none on the keyboard page
+        uint16_t evdev;    // Linux KEY_* / BTN_* code
+        uint8_t vk;        // Windows virtual key (key state index)
+        uint16_t scancode; // Set-1 make code, 0xE0xx for E0-prefixed keys
+        const char* name;
+    };
+
+    constexpr KeyCodeEntry KEY_CODE_TABLE[] = {
+    { 0x04, 30,    'A',                   0x1E,   "a" },
+    { 0x05, 48,    'B',                   0x30,   "b" },
+    { 0x06, 46,    'C',                   0x2E,   "c" },
+    { 0x07, 32,    'D',                   0x20,   "d" },
+    { 0x08, 18,    'E',                   0x12,   "e" },
+    { 0x09, 33,    'F',                   0x21,   "f" },
+    { 0x0A, 34,    'G',                   0x22,   "g" },
+    { 0x0B, 35,    'H',                   0x23,   "h" },
+    { 0x0C, 23,    'I',                   0x17,   "i" },
+    { 0x0D, 36,    'J',                   0x24,   "j" },
+    { 0x0E, 37,    'K',                   0x25,   "k" },
+    { 0x0F, 38,    'L',                   0x26,   "l" },
+    { 0x10, 50,    'M',                   0x32,   "m" },
+    { 0x11, 49,    'N',                   0x31,   "n" },
+    { 0x12, 24,    'O',                   0x18,   "o" },
+    { 0x13, 25,    'P',                   0x19,   "p" },
+    { 0x14, 16,    'Q',                   0x10,   "q" },
+    { 0x15, 19,    'R',                   0x13,   "r" },
+    { 0x16, 31,    'S',                   0x1F,   "s" },
+    { 0x17, 20,    'T',                   0x14,   "t" },
+    { 0x18, 22,    'U',                   0x16,   "u" },
+    { 0x19, 47,    'V',                   0x2F,   "v" },
+    { 0x1A, 17,    'W',                   0x11,   "w" },
+    { 0x1B, 45,    'X',                   0x2D,   "x" },
+    { 0x1C, 21,    'Y',                   0x15,   "y" },
+    { 0x1D, 44,    'Z',                   0x2C,   "z" },
+    { 0x1E, 2,     '1',                   0x02,   "1" },
+    { 0x1F, 3,     '2',                   0x03,   "2" },
+    { 0x20, 4,     '3',                   0x04,   "3" },
+    { 0x21, 5,     '4',                   0x05,   "4" },
+    { 0x22, 6,     '5',                   0x06,   "5" },
+    { 0x23, 7,     '6',                   0x07,   "6" },
+    { 0x24, 8,     '7',                   0x08,   "7" },
+    { 0x25, 9,     '8',                   0x09,   "8" },
+    { 0x26, 10,    '9',                   0x0A,   "9" },
+    { 0x27, 11,    '0',                   0x0B,   "0" },
+    { 0x28, 28,    VK_RETURN,             0x1C,   "enter" },
+    { 0x29, 1,     VK_ESCAPE,             0x01,   "escape" },
+    { 0x2A, 14,    VK_BACK,               0x0E,   "backspace" },
+    { 0x2B, 15,    VK_TAB,                0x0F,   "tab" },
+    { 0x2C, 57,    VK_SPACE,              0x39,   "space" },
+    { 0x2D, 12,    VK_OEM_MINUS,          0x0C,   "minus" },
+    { 0x2E, 13,    VK_OEM_PLUS,           0x0D,   "equal" },
+    { 0x2F, 26,    VK_OEM_4,              0x1A,   "left_bracket" },
+    { 0x30, 27,    VK_OEM_6,              0x1B,   "right_bracket" },
+    { 0x31, 43,    VK_OEM_5,              0x2B,   "backslash" },
+    { 0x33, 39,    VK_OEM_1,              0x27,   "semicolon" },
+    { 0x34, 40,    VK_OEM_7,              0x28,   "apostrophe" },
+    { 0x35, 41,    VK_OEM_3,              0x29,   "grave" },
+    { 0x36, 51,    VK_OEM_COMMA,          0x33,   "comma" },
+    { 0x37, 52,    VK_OEM_PERIOD,         0x34,   "period" },
+    { 0x38, 53,    VK_OEM_2,              0x35,   "slash" },
+    { 0x39, 58,    VK_CAPITAL,            0x3A,   "caps_lock" },
+    { 0x3A, 59,    VK_F1,                 0x3B,   "f1" },
+    { 0x3B, 60,    VK_F2,                 0x3C,   "f2" },
+    { 0x3C, 61,    VK_F3,                 0x3D,   "f3" },
+    { 0x3D, 62,    VK_F4,                 0x3E,   "f4" },
+    { 0x3E, 63,    VK_F5,                 0x3F,   "f5" },
+    { 0x3F, 64,    VK_F6,                 0x40,   "f6" },
+    { 0x40, 65,    VK_F7,                 0x41,   "f7" },
+    { 0x41, 66,    VK_F8,                 0x42,   "f8" },
+    { 0x42, 67,    VK_F9,                 0x43,   "f9" },
+    { 0x43, 68,    VK_F10,                0x44,   "f10" },
+    { 0x44, 87,    VK_F11,                0x57,   "f11" },
+    { 0x45, 88,    VK_F12,                0x58,   "f12" },
+    { 0x46, 99,    VK_SNAPSHOT,           0xE037, "print_screen" },
+    { 0x47, 70,    VK_SCROLL,             0x46,   "scroll_lock" },
+    { 0x48, 119,   VK_PAUSE,              0xE045, "pause" },
+    { 0x49, 110,   VK_INSERT,             0xE052, "insert" },
+    { 0x4A, 102,   VK_HOME,               0xE047, "home" },
+    { 0x4B, 104,   VK_PRIOR,              0xE049, "page_up" },
+    { 0x4C, 111,   VK_DELETE,             0xE053, "delete" },
+    { 0x4D, 107,   VK_END,                0xE04F, "end" },
+    { 0x4E, 109,   VK_NEXT,               0xE051, "page_down" },
+    { 0x4F, 106,   VK_RIGHT,              0xE04D, "right" },
+    { 0x50, 105,   VK_LEFT,               0xE04B, "left" },
+    { 0x51, 108,   VK_DOWN,               0xE050, "down" },
+    { 0x52, 103,   VK_UP,                 0xE048, "up" },
+    { 0x53, 69,    VK_NUMLOCK,            0x45,   "num_lock" },
+    { 0x54, 98,    VK_DIVIDE,             0xE035, "kp_divide" },
+    { 0x55, 55,    VK_MULTIPLY,           0x37,   "kp_multiply" },
+    { 0x56, 74,    VK_SUBTRACT,           0x4A,   "kp_subtract" },
+    { 0x57, 78,    VK_ADD,                0x4E,   "kp_add" },
+    { 0x58, 96,    VK_RETURN,             0xE01C, "kp_enter" },
+    { 0x59, 79,    VK_NUMPAD1,            0x4F,   "kp_1" },
+    { 0x5A, 80,    VK_NUMPAD2,            0x50,   "kp_2" },
+    { 0x5B, 81,    VK_NUMPAD3,            0x51,   "kp_3" },
+    { 0x5C, 75,    VK_NUMPAD4,            0x4B,   "kp_4" },
+    { 0x5D, 76,    VK_NUMPAD5,            0x4C,   "kp_5" },
+    { 0x5E, 77,    VK_NUMPAD6,            0x4D,   "kp_6" },
+    { 0x5F, 71,    VK_NUMPAD7,            0x47,   "kp_7" },
+    { 0x60, 72,    VK_NUMPAD8,            0x48,   "kp_8" },
+    { 0x61, 73,    VK_NUMPAD9,            0x49,   "kp_9" },
+    { 0x62, 82,    VK_NUMPAD0,            0x52,   "kp_0" },
+    { 0x63, 83,    VK_DECIMAL,            0x53,   "kp_decimal" },
+    { 0x64, 86,    VK_OEM_102,            0x56,   "iso_backslash" },
+    { 0x65, 127,   VK_APPS,               0xE05D, "menu" },
+    { 0x68, 183,   VK_F13,                0x64,   "f13" },
+    { 0x69, 184,   VK_F14,                0x65,   "f14" },
+    { 0x6A, 185,   VK_F15,                0x66,   "f15" },
+    { 0x6B, 186,   VK_F16,                0x67,   "f16" },
+    { 0x6C, 187,   VK_F17,                0x68,   "f17" },
+    { 0x6D, 188,   VK_F18,                0x69,   "f18" },
+    { 0x6E, 189,   VK_F19,                0x6A,   "f19" },
+    { 0x6F, 190,   VK_F20,                0x6B,   "f20" },
+    { 0x70, 191,   VK_F21,                0x6C,   "f21" },
+    { 0x71, 192,   VK_F22,                0x6D,   "f22" },
+    { 0x72, 193,   VK_F23,                0x6E,   "f23" },
+    { 0x73, 194,   VK_F24,                0x76,   "f24" },
+    { 0x7F, 113,   VK_VOLUME_MUTE,        0xE020, "volume_mute" },
+    { 0x80, 115,   VK_VOLUME_UP,          0xE030, "volume_up" },
+    { 0x81, 114,   VK_VOLUME_DOWN,        0xE02E, "volume_down" },
+    { 0,    163,   VK_MEDIA_NEXT_TRACK,   0xE019, "media_next" },
+    { 0,    165,   VK_MEDIA_PREV_TRACK,   0xE010, "media_prev" },
+    { 0,    166,   VK_MEDIA_STOP,         0xE024, "media_stop" },
+    { 0,    164,   VK_MEDIA_PLAY_PAUSE,   0xE022, "media_play_pause" },
+    { 0,    158,   VK_BROWSER_BACK,       0xE06A, "browser_back" },
+    { 0,    159,   VK_BROWSER_FORWARD,    0xE069, "browser_forward" },
+    { 0,    173,   VK_BROWSER_REFRESH,    0xE067, "browser_refresh" },
+    { 0,    217,   VK_BROWSER_SEARCH,     0xE065, "browser_search" },
+    { 0,    172,   VK_BROWSER_HOME,       0xE032, "browser_home" },
+    { 0,    155,   VK_LAUNCH_MAIL,        0xE06C, "launch_mail" },
+    { 0,    140,   VK_LAUNCH_APP2,        0xE021, "launch_app2" },
+    { 0xE0, 29,    VK_LCONTROL,           0x1D,   "left_ctrl" },
+    { 0xE1, 42,    VK_LSHIFT,             0x2A,   "left_shift" },
+    { 0xE2, 56,    VK_LMENU,              0x38,   "left_alt" },
+    { 0xE3, 125,   VK_LWIN,               0xE05B, "left_meta" },
+    { 0xE4, 97,    VK_RCONTROL,           0xE01D, "right_ctrl" },
+    { 0xE5, 54,    VK_RSHIFT,             0x36,   "right_shift" },
+    { 0xE6, 100,   VK_RMENU,              0xE038, "right_alt" },
+    { 0xE7, 126,   VK_RWIN,               0xE05C, "right_meta" },
+    { 0,    0x110, VK_LBUTTON,            0,      "mouse_left" },
+    { 0,    0x111, VK_RBUTTON,            0,      "mouse_right" },
+    { 0,    0x112, VK_MBUTTON,            0,      "mouse_middle" },
+    { 0,    0x113, VK_XBUTTON1,           0,      "mouse_x1" },
+    { 0,    0x114, VK_XBUTTON2,           0,      "mouse_x2" },
+    };
+
+    constexpr int KEY_CODE_COUNT = static_cast<int>(sizeof(KEY_CODE_TABLE) / sizeof(KEY_CODE_TABLE[0]));
+    constexpr int HID_CODE_LIMIT = 0x100;
+    constexpr int EVDEV_CODE_LIMIT = 0x300;
+    constexpr int VK_CODE_LIMIT = 0x100;
+    constexpr int SCANCODE_LIMIT = 0x200; // Low byte plus one bit for the E0 prefix
+
+    static_assert(KEY_CODE_COUNT < 0xFF, "Entry indices must fit in uint8_t");
+
+    namespace Detail
+    {
+        // Maps a code to its KEY_CODE_TABLE entry index + 1 (0 = no entry)
+        template <int N>
+        struct IndexTable
+        {
+            uint8_t entry[N] = {};
+        };
+
+        constexpr int ScancodeSlot(int scancode)
+        {
+            return (scancode & 0xFF) | ((scancode & 0xFF00) != 0 ? 0x100 : 0);
+        }
+
+        constexpr IndexTable<HID_CODE_LIMIT> BuildHIDIndex()
+        {
+            IndexTable<HID_CODE_LIMIT> table;
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                if (KEY_CODE_TABLE[i].hid != 0 && table.entry[KEY_CODE_TABLE[i].hid] == 0)
+                    table.entry[KEY_CODE_TABLE[i].hid] = static_cast<uint8_t>(i + 1);
+            }
+            return table;
+        }
+
+        constexpr IndexTable<EVDEV_CODE_LIMIT> BuildEvdevIndex()
+        {
+            IndexTable<EVDEV_CODE_LIMIT> table;
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                if (KEY_CODE_TABLE[i].evdev != 0 && table.entry[KEY_CODE_TABLE[i].evdev] == 0)
+                    table.entry[KEY_CODE_TABLE[i].evdev] = static_cast<uint8_t>(i + 1);
+            }
+            return table;
+        }
+
+        constexpr IndexTable<SCANCODE_LIMIT> BuildScancodeIndex()
+        {
+            IndexTable<SCANCODE_LIMIT> table;
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                int slot = ScancodeSlot(KEY_CODE_TABLE[i].scancode);
+                if (KEY_CODE_TABLE[i].scancode != 0 && table.entry[slot] == 0)
+                    table.entry[slot] = static_cast<uint8_t>(i + 1);
+            }
+            return table;
+        }
+
+        constexpr IndexTable<VK_CODE_LIMIT> BuildVirtualKeyIndex()
+        {
+            IndexTable<VK_CODE_LIMIT> table;
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                // First entry wins, e.g. VK_RETURN maps back to Enter, not keypad Enter
+                if (table.entry[KEY_CODE_TABLE[i].vk] == 0)
+                    table.entry[KEY_CODE_TABLE[i].vk] = static_cast<uint8_t>(i + 1);
+            }
+
+            // Generic modifiers translate back to their left-hand key
+            table.entry[VK_SHIFT] = table.entry[VK_LSHIFT];
+            table.entry[VK_CONTROL] = table.entry[VK_LCONTROL];
+            table.entry[VK_MENU] = table.entry[VK_LMENU];
+            return table;
+        }
+    }
+
+    constexpr Detail::IndexTable<HID_CODE_LIMIT> HID_INDEX = Detail::BuildHIDIndex();
+    constexpr Detail::IndexTable<EVDEV_CODE_LIMIT> EVDEV_INDEX = Detail::BuildEvdevIndex();
+    constexpr Detail::IndexTable<SCANCODE_LIMIT> SCANCODE_INDEX = Detail::BuildScancodeIndex();
+    constexpr Detail::IndexTable<VK_CODE_LIMIT> VK_INDEX = Detail::BuildVirtualKeyIndex();
+
+    // Entry for a code, or nullptr if the code is unknown
+    constexpr const KeyCodeEntry* FindByHID(int hidCode)
+    {
+        return (hidCode > 0 && hidCode < HID_CODE_LIMIT && HID_INDEX.entry[hidCode] != 0)
+            ? &KEY_CODE_TABLE[HID_INDEX.entry[hidCode] - 1] : nullptr;
+    }
+
+    constexpr const KeyCodeEntry* FindByEvdev(int evdevCode)
+    {
+        return (evdevCode > 0 && evdevCode < EVDEV_CODE_LIMIT && EVDEV_INDEX.entry[evdevCode] != 0)
+            ? &KEY_CODE_TABLE[EVDEV_INDEX.entry[evdevCode] - 1] : nullptr;
+    }
+
+    constexpr const KeyCodeEntry* FindByScancode(int scancode)
+    {
+        return (scancode > 0 && scancode <= 0xFFFF && SCANCODE_INDEX.entry[Detail::ScancodeSlot(scancode)] != 0)
+            ? &KEY_CODE_TABLE[SCANCODE_INDEX.entry[Detail::ScancodeSlot(scancode)] - 1] : nullptr;
+    }
+
+    constexpr const KeyCodeEntry* FindByVirtualKey(int virtualKey)
+    {
+        return (virtualKey > 0 && virtualKey < VK_CODE_LIMIT && VK_INDEX.entry[virtualKey] != 0)
+            ? &KEY_CODE_TABLE[VK_INDEX.entry[virtualKey] - 1] : nullptr;
+    }
+
+    // Entry by its name ("a", "left_shift", "kp_enter"). Searches the table,
+    // so it is meant for loading layouts, not for translating live input.
+    constexpr const KeyCodeEntry* FindByName(std::string_view name)
+    {
+        for (int i = 0; i < KEY_CODE_COUNT; ++i)
+        {
+            if (name == KEY_CODE_TABLE[i].name)
+                return &KEY_CODE_TABLE[i];
+        }
+        return nullptr;
+    }
+
+    constexpr int HIDToVirtualKey(int hidCode)
+    {
+        return FindByHID(hidCode) ? FindByHID(hidCode)->vk : 0;
+    }
+
+    constexpr int EvdevToVirtualKey(int evdevCode)
+    {
+        return FindByEvdev(evdevCode) ? FindByEvdev(evdevCode)->vk : 0;
+    }
+
+    constexpr int ScancodeToVirtualKey(int scancode)
+    {
+        return FindByScancode(scancode) ? FindByScancode(scancode)->vk : 0;
+    }
+
+    constexpr int VirtualKeyToHID(int virtualKey)
+    {
+        return FindByVirtualKey(virtualKey) ? FindByVirtualKey(virtualKey)->hid : 0;
+    }
+
+    constexpr int VirtualKeyToEvdev(int virtualKey)
+    {
+        return FindByVirtualKey(virtualKey) ? FindByVirtualKey(virtualKey)->evdev : 0;
+    }
+
+    constexpr int VirtualKeyToScancode(int virtualKey)
+    {
+        return FindByVirtualKey(virtualKey) ? FindByVirtualKey(virtualKey)->scancode : 0;
+    }
+
+    namespace Detail
+    {
+        // No HID usage, evdev code or scancode may appear twice in the table
+        constexpr bool HasUniqueCodes()
+        {
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                for (int j = i + 1; j < KEY_CODE_COUNT; ++j)
+                {
+                    const KeyCodeEntry& a = KEY_CODE_TABLE[i];
+                    const KeyCodeEntry& b = KEY_CODE_TABLE[j];
+                    if (a.hid != 0 && a.hid == b.hid)
+                        return false;
+                    if (a.evdev != 0 && a.evdev == b.evdev)
+                        return false;
+                    if (a.scancode != 0 && ScancodeSlot(a.scancode) == ScancodeSlot(b.scancode))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // Every code translates to its own entry's virtual key, and every
+        // virtual key translates back to an entry with the same virtual key
+        constexpr bool RoundTrips()
+        {
+            for (int i = 0; i < KEY_CODE_COUNT; ++i)
+            {
+                const KeyCodeEntry& e = KEY_CODE_TABLE[i];
+                if (e.vk == 0 || e.evdev >= EVDEV_CODE_LIMIT)
+                    return false;
+                if (e.hid != 0 && HIDToVirtualKey(e.hid) != e.vk)
+                    return false;
+                if (e.evdev != 0 && EvdevToVirtualKey(e.evdev) != e.vk)
+                    return false;
+                if (e.scancode != 0 && ScancodeToVirtualKey(e.scancode) != e.vk)
+                    return false;
+                if (FindByVirtualKey(e.vk) == nullptr || FindByVirtualKey(e.vk)->vk != e.vk)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    static_assert(Detail::HasUniqueCodes(), "KEY_CODE_TABLE has duplicate HID, evdev or scancode values");
+    static_assert(Detail::RoundTrips(), "KEY_CODE_TABLE lookups are inconsistent");
+    static_assert(HIDToVirtualKey(26) == 'W' && EvdevToVirtualKey(17) == 'W' && ScancodeToVirtualKey(0x11) == 'W',
+                  "Letter mapping");
+    static_assert(HIDToVirtualKey(0xE5) == VK_RSHIFT && ScancodeToVirtualKey(0xE01D) == VK_RCONTROL,
+                  "Right-hand modifier mapping");
+    static_assert(VirtualKeyToHID(VK_SHIFT) == 0xE1 && VirtualKeyToEvdev(VK_CONTROL) == 29,
+                  "Generic modifiers map to the left-hand key");
+    static_assert(EvdevToVirtualKey(0x110) == VK_LBUTTON, "Mouse button mapping");
+    static_assert(FindByName("kp_enter") && FindByName("kp_enter")->hid == 0x58 && !FindByName("kp enter"),
+                  "Name lookup");
+
+    // Resolves a binding to its key state index using WinVK > HID > Evdev priority.
+    // Returns 0 if the key cannot be resolved.
+    int ResolveInputKey(const InputKey& key);
+
+    // Returns the generic modifier (VK_SHIFT, VK_CONTROL, VK_MENU) for a
+    // left/right modifier, or 0 if the key is not a sided modifier
+    int GenericModifier(int virtualKey);
+}
\ No newline at end of file
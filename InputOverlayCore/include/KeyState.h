@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Common.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Fixed-size set of pressed keys indexed by virtual key code (0-255).
+// 256 bits = half a cache line; copies and edge detection are a few word ops
+// and never touch the heap.
+class KeyStateSet
+{
+public:
+    static const int KEY_COUNT = 256;
+    static const int WORD_COUNT = KEY_COUNT / 64;
+
+    void Set(int code, bool down)
+    {
+        uint64_t mask = 1ULL << (code & 63);
+        uint64_t& word = m_words[(code >> 6) & (WORD_COUNT - 1)];
+        word = down ? (word | mask) : (word & ~mask);
+    }
+
+    bool Test(int code) const
+    {
+        return (m_words[(code >> 6) & (WORD_COUNT - 1)] >> (code & 63)) & 1ULL;
+    }
+
+    void Clear()
+    {
+        for (int i = 0; i < WORD_COUNT; ++i)
+            m_words[i] = 0;
+    }
+
+    bool Any() const
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            any |= m_words[i];
+        return any != 0;
+    }
+
+    uint64_t Word(int index) const { return m_words[index]; }
+
+    // Keys set in either set
+    static KeyStateSet Union(const KeyStateSet& a, const KeyStateSet& b)
+    {
+        KeyStateSet result;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            result.m_words[i] = a.m_words[i] | b.m_words[i];
+        return result;
+    }
+
+    // Keys whose state differs between the two sets
+    static KeyStateSet Changed(const KeyStateSet& previous, const KeyStateSet& current)
+    {
+        KeyStateSet result;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            result.m_words[i] = previous.m_words[i] ^ current.m_words[i];
+        return result;
+    }
+
+    // Keys that went down between previous and current
+    static KeyStateSet Pressed(const KeyStateSet& previous, const KeyStateSet& current)
+    {
+        KeyStateSet result;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            result.m_words[i] = (previous.m_words[i] ^ current.m_words[i]) & current.m_words[i];
+        return result;
+    }
+
+    // Keys that went up between previous and current
+    static KeyStateSet Released(const KeyStateSet& previous, const KeyStateSet& current)
+    {
+        KeyStateSet result;
+        for (int i = 0; i < WORD_COUNT; ++i)
+            result.m_words[i] = (previous.m_words[i] ^ current.m_words[i]) & previous.m_words[i];
+        return result;
+    }
+
+    // Calls fn(code) for every set key, lowest code first
+    template <typename Fn>
+    void ForEach(Fn fn) const
+    {
+        for (int i = 0; i < WORD_COUNT; ++i)
+        {
+            uint64_t word = m_words[i];
+            while (word != 0)
+            {
+                fn(i * 64 + CountTrailingZeros(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    alignas(32) uint64_t m_words[WORD_COUNT] = {};
+
+    static int CountTrailingZeros(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#ifdef _WIN64
+        _BitScanForward64(&index, value);
+#else
+        if (!_BitScanForward(&index, static_cast<unsigned long>(value)))
+        {
+            _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+            index += 32;
+        }
+#endif
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+};
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+#include "JSONDocument.h"
+
+// Builds keyboard presets from a compact layout description instead of a
+// hand-written elements array:
+//
+//   {
+//     "layout": "ansi104",                 built-in rows, or "rows": [...]
+//     "texture": { "file": "keyboard.png", "size": [1200, 700] },
+//     "key_size": [50, 50],                canvas pixels of a 1u key
+//     "spacing": 4,                        gap between neighbouring keys
+//     "sheet": { "origin": [0, 0], "pressed_offset": [0, 350] }
+//   }
+//
+// Each row is a string of key names from KeyCodes ("escape", "a",
+// "left_shift", "kp_enter"). "name:1.5" makes a key 1.5 units wide and
+// "name:1:2" two rows tall; "_" (or "_:0.5") leaves a gap. A number between
+// rows is extra vertical space, in units. Element ids are the key names and
+// their HID, virtual key and evdev codes come from the translation tables.
+//
+// The sprite sheet is drawn on the same grid: a key's normal sprite sits at
+// sheet.origin plus its position on the canvas, and the pressed sprites are
+// sheet.pressed_offset away (written as defaults.pressed_offset). By default
+// the pressed copy is directly below the normal one, the canvas is the size of
+// the layout and texture.size the size of the whole sheet.
+namespace LayoutGenerator
+{
+    // Description text of a built-in layout ("ansi104", "ansi60"), or nullptr
+    const char* FindBuiltinLayout(std::string_view name);
+
+    // Fills 'config' from a layout description. Unknown or repeated key names
+    // fail with a message. Key bindings are not resolved; call
+    // ConfigParser::ResolveKeyBindings().
+    bool Generate(const JSONValue& layout, OverlayConfig& config);
+    bool GenerateFromText(std::string_view layoutJson, OverlayConfig& config);
+
+    // Writes the preset JSON to 'presetPath'; with 'compile' also its
+    // .aiocache, so the first load does not parse the JSON at all
+    bool Save(const OverlayConfig& config, const std::string& presetPath, bool compile);
+}
\ No newline at end of file
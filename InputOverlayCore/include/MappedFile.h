@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+
+// Read-only memory mapping of a whole file.
+// The view stays valid until Close() or destruction; nothing is copied.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false without logging; a missing file is often expected (caches)
+    bool Open(const std::string& filePath);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+
+#ifdef _WIN32
+    HANDLE m_hFile;
+    HANDLE m_hMapping;
+#else
+    int m_fd;
+#endif
+};
\ No newline at end of file
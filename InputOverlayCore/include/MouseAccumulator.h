@@ -0,0 +1,71 @@
+#pragma once
+
+#include "InputBackend.h"
+#include <atomic>
+
+// Relative mouse motion summed between two frames
+struct MouseDelta
+{
+    int dx = 0;
+    int dy = 0;
+    int wheel = 0;            // 120 per notch
+    uint64_t timestampNs = 0; // Time of the newest sample, 0 if none
+};
+
+// Lock-free sum of raw mouse motion.
+// The capture thread adds every device report (1000 Hz+ for gaming mice) and
+// the frame loop drains the totals once per Update(), so per-frame movement is
+// the exact sum of what the device reported, independent of cursor clipping
+// or frame rate. A sample that lands during Drain() is counted in the next frame.
+class MouseAccumulator
+{
+public:
+    // Capture thread
+    void AddMotion(uint64_t timestampNs, int dx, int dy)
+    {
+        m_dx.fetch_add(dx, std::memory_order_relaxed);
+        m_dy.fetch_add(dy, std::memory_order_relaxed);
+        m_timestampNs.store(timestampNs, std::memory_order_release);
+    }
+
+    void AddWheel(uint64_t timestampNs, int delta)
+    {
+        m_wheel.fetch_add(delta, std::memory_order_relaxed);
+        m_timestampNs.store(timestampNs, std::memory_order_release);
+    }
+
+    // Frame loop: returns the totals since the previous Drain() and resets them
+    MouseDelta Drain()
+    {
+        MouseDelta delta;
+        delta.timestampNs = m_timestampNs.exchange(0, std::memory_order_acquire);
+        delta.dx = m_dx.exchange(0, std::memory_order_relaxed);
+        delta.dy = m_dy.exchange(0, std::memory_order_relaxed);
+        delta.wheel = m_wheel.exchange(0, std::memory_order_relaxed);
+        return delta;
+    }
+
+    // Appends one Relative event per non-zero axis
+    static void AppendEvents(const MouseDelta& delta, uint64_t timestampNs, std::vector<InputEvent>& events)
+    {
+        const int values[3] = { delta.dx, delta.dy, delta.wheel };
+        for (int axis = INPUT_AXIS_X; axis <= INPUT_AXIS_WHEEL; ++axis)
+        {
+            if (values[axis] == 0)
+                continue;
+
+            InputEvent event;
+            event.timestampNs = delta.timestampNs != 0 ? delta.timestampNs : timestampNs;
+            event.type = InputEventType::Relative;
+            event.code = axis;
+            event.value = values[axis];
+            events.push_back(event);
+        }
+    }
+
+private:
+    std::atomic<int> m_dx{0};
+    std::atomic<int> m_dy{0};
+    std::atomic<int> m_wheel{0};
+    std::atomic<uint64_t> m_timestampNs{0};
+};
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+
+// Binary payload of IPCMessageType::MOUSE_EVENT: the mouse samples of one
+// frame, delta coded with varints. A frame of plain motion takes about ten
+// bytes; neither side allocates or parses text.
+//
+//   uint8    FORMAT_VERSION
+//   varint   sample count (1..MAX_SAMPLES)
+//   per sample:
+//     uint8  flags: MOUSE_BUTTON_* held in the low 5 bits, plus the
+//            SAMPLE_* bits below for the fields that follow
+//     varint time in microseconds: absolute for the first sample, since
+//            the previous sample after that
+//     [zigzag x, zigzag y]  SAMPLE_POSITION: change from the previous
+//                           sample's position, which starts at (0, 0)
+//     [zigzag x, zigzag y]  SAMPLE_MOVEMENT: relative motion
+//     [zigzag]              SAMPLE_WHEEL: wheel delta
+// A field that is left out is unchanged (position) or zero (the others).
+namespace MouseEventCodec
+{
+    const uint8_t FORMAT_VERSION = 1;
+
+    // Samples per frame; InputDetection folds any beyond this into the last one
+    const int MAX_SAMPLES = 32;
+
+    const uint8_t SAMPLE_POSITION = 1 << 5;
+    const uint8_t SAMPLE_MOVEMENT = 1 << 6;
+    const uint8_t SAMPLE_WHEEL = 1 << 7;
+
+    // Worst case: flags, a 64-bit time and five 32-bit fields per sample
+    const size_t MAX_SAMPLE_SIZE = 1 + 10 + 5 * 5;
+    const size_t MAX_PACKET_SIZE = 1 + 5 + MAX_SAMPLES * MAX_SAMPLE_SIZE;
+
+    // Writes up to MAX_SAMPLES samples to 'out' (MAX_PACKET_SIZE bytes) and
+    // returns the packet size
+    size_t Encode(const MouseSample* samples, int count, uint8_t* out);
+
+    // 'samples' must hold MAX_SAMPLES; false for a truncated or malformed packet
+    bool Decode(const uint8_t* data, size_t size, MouseSample* samples, int& count);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "IPCTransport.h"
+
+#ifdef _WIN32
+
+#include <atomic>
+#include <mutex>
+
+// Windows transport: the PIPE_NAME message-mode named pipe the UI opens.
+// The pipe is opened for overlapped I/O; blocking calls wait on their
+// operation's event together with a stop event that Shutdown() sets.
+class NamedPipeTransport : public IPCTransport
+{
+public:
+    NamedPipeTransport();
+    ~NamedPipeTransport() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+    const char* GetName() const override { return "named pipe"; }
+
+    bool WaitForClient() override;
+    void Disconnect() override;
+    bool Read(std::string& message) override;
+    bool Write(const std::string& message) override;
+
+private:
+    HANDLE m_hPipe;          // Closed by the destructor only, once no thread uses it
+    HANDLE m_stopEvent;      // Manual-reset, set by Shutdown()
+    HANDLE m_readEvent;      // Overlapped events of the reader (connect, read)
+    HANDLE m_writeEvent;     // and the writer thread
+    std::atomic<bool> m_shouldStop;
+    std::atomic<bool> m_connected;
+    std::mutex m_readMutex;  // Held by WaitForClient()/Read() and Write() while they
+    std::mutex m_writeMutex; // use the pipe, so the destructor never closes it under them
+
+    // Finishes an overlapped operation whose call returned 'started': waits
+    // for it or for Shutdown(), which cancels it. False on failure, with the
+    // error in GetLastError().
+    bool Complete(BOOL started, OVERLAPPED& overlapped, DWORD& bytes);
+};
+
+#endif
\ No newline at end of file
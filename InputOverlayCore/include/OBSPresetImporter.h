@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Common.h"
+#include "JSONDocument.h"
+
+// Import of presets in the OBS input-overlay plugin format (see obs-preset/).
+//
+// That schema describes each element by a numeric "type", a libuiohook key
+// "code", a texture "mapping" rect and "z_level". Pressed states are not
+// listed; the plugin finds them at fixed offsets in the texture, which this
+// importer turns into explicit sprite rects:
+//   keys, mouse buttons  pressed = mapping moved down by height + 3
+//   scroll wheel         pressed, up, down = mapping moved right by 1, 2, 3 x (width + 3)
+namespace OBSPreset
+{
+    // OBS element types
+    enum ElementType
+    {
+        ELEMENT_TEXTURE = 0,
+        ELEMENT_KEYBOARD_KEY = 1,
+        ELEMENT_GAMEPAD_BUTTON = 2,
+        ELEMENT_MOUSE_BUTTON = 3,
+        ELEMENT_MOUSE_WHEEL = 4,
+        ELEMENT_ANALOG_STICK = 5,
+        ELEMENT_TRIGGER = 6,
+        ELEMENT_TEXT = 7,
+        ELEMENT_DPAD = 8,
+        ELEMENT_MOUSE_MOVEMENT = 9,
+        ELEMENT_GAMEPAD_ID = 10
+    };
+
+    // True if 'root' looks like an OBS preset rather than our schema
+    bool IsOBSPreset(const JSONValue& root);
+
+    // Translates an OBS preset into 'config'. Elements of types we cannot
+    // drive (gamepad, text) are kept as static textures so the layout still
+    // draws. Key bindings are not resolved; call ConfigParser::ResolveKeyBindings().
+    bool Import(const JSONValue& root, OverlayConfig& config);
+
+    // libuiohook key code (set-1 scancode, 0x0Exx for E0-prefixed keys) to virtual key
+    int UiohookToVirtualKey(int code);
+
+    // Texture used by an OBS preset file: "<name>.png" beside it, else
+    // "<folder name>.png" (presets sharing one sheet). Empty if neither exists.
+    std::string FindTextureFile(const std::string& presetPath);
+}
\ No newline at end of file
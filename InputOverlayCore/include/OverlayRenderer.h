@@ -12,15 +12,41 @@ public:
     void Shutdown();
 
     std::unique_ptr<sf::RenderWindow> CreateOverlayWindow(const OverlayConfig& config, bool noBorders, bool topMost);
-    void RenderOverlay(sf::RenderWindow& window, const OverlayConfig& config);
+    void RenderOverlay(int overlayId, sf::RenderWindow& window, const OverlayConfig& config);
+
+    // After ConfigParser::ApplyPatch(): rebuilds the sprites of the changed
+    // elements only and keeps the rest of the overlay's render state
+    void ApplyChanges(int overlayId, const OverlayConfig& config, const std::vector<ConfigChange>& changes);
+
+    // Drops the render state of an overlay that was removed or replaced
+    void RemoveOverlay(int overlayId);
+
+    // Re-uploads a texture whose file changed; sprites using it stay valid
+    bool ReloadTexture(const std::string& filePath);
 
 private:
+    // Sprites of one element, built once and reused every frame
+    struct ElementSprites
+    {
+        sf::Sprite states[SPRITE_STATE_COUNT]; // Indexed by SpriteState
+    };
+
+    struct RenderCache
+    {
+        const sf::Texture* texture = nullptr;
+        std::vector<ElementSprites> sprites;  // Parallel to config.elements
+        std::vector<uint32_t> drawOrder;      // Element indices by z-order
+        bool orderDirty = true;
+    };
+
     std::map<std::string, sf::Texture> m_textures;
+    std::map<int, RenderCache> m_renderCaches;
     sf::Font m_debugFont;
 
     bool LoadTexture(const std::string& filePath);
     sf::Texture* GetTexture(const std::string& filePath);
-    void DrawElement(sf::RenderWindow& window, const OverlayElement& element, const sf::Texture& texture);
+    void BuildElementSprites(const OverlayElement& element, const sf::Texture& texture, ElementSprites& sprites);
+    void SortDrawOrder(const OverlayConfig& config, RenderCache& cache);
     void SetWindowProperties(sf::RenderWindow& window, bool noBorders, bool topMost);
 };
 
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Common.h"
+#include <string_view>
+
+// Compiled binary form of an OverlayConfig (.aiocache).
+//
+// A cache file is tied to the exact JSON text it was built from by a 64-bit
+// FNV-1a hash of that text (word-at-a-time, see HashText()); any edit to the
+// preset changes the hash and the cache is ignored. All references inside the file are offsets from its start,
+// so it can be memory mapped anywhere and read in place.
+//
+// Layout (little endian, 4-byte aligned):
+//   CacheHeader
+//   CacheElement[elementCount]  at elementsOffset
+//   string bytes                referenced by StringRef {offset, length}
+namespace PresetCache
+{
+    const char MAGIC[4] = { 'A', 'I', 'O', 'C' };
+    const uint16_t VERSION = 1;
+
+    // Cache file used for a preset on disk
+    inline std::string CachePathFor(const std::string& presetPath) { return presetPath + ".aiocache"; }
+
+    uint64_t HashText(std::string_view text);
+
+    // Appends the binary form of 'config' to 'out'
+    void Serialize(const OverlayConfig& config, uint64_t contentHash, std::vector<uint8_t>& out);
+
+    // Rebuilds 'config' from a cache image. Fails if the image is malformed, from
+    // another format version, or was built from different JSON text.
+    // Key bindings are not resolved; call ConfigParser::ResolveKeyBindings().
+    bool Deserialize(const uint8_t* data, size_t size, uint64_t expectedHash, OverlayConfig& config);
+
+    // Maps 'cachePath' and deserializes it; false if missing or stale
+    bool Load(const std::string& cachePath, uint64_t expectedHash, OverlayConfig& config);
+
+    // Writes the cache next to a temporary name and renames it into place, so
+    // a concurrent reader never sees a partial file
+    bool Save(const std::string& cachePath, uint64_t contentHash, const OverlayConfig& config);
+}
\ No newline at end of file
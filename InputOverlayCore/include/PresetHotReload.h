@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ConfigParser.h"
+#include "FileWatcher.h"
+
+// What one reload did to an overlay
+struct PresetReload
+{
+    int overlayId = 0;
+    std::vector<ConfigChange> changes;  // Element edits made to the live config
+    bool replaced = false;              // Elements could not be matched; config was swapped whole
+    bool textureChanged = false;        // PNG rewritten, or the preset now names another one
+    uint64_t detectedNs = 0;            // When the file change was seen
+    double parseMs = 0.0;
+};
+
+// Watches the preset and texture files behind loaded overlays and merges
+// edits into the live configs, so a preset can be tweaked while streaming
+// without re-adding the overlay.
+class PresetHotReload
+{
+public:
+    bool Initialize();
+    void Shutdown();
+
+    // 'dependencies' are the parents and includes the preset was composed from
+    // (ConfigParser::GetDependencies()); editing one reloads the preset too
+    void Track(int overlayId, const std::string& presetPath, const OverlayConfig& config,
+               const std::vector<std::string>& dependencies = {});
+    void Untrack(int overlayId);
+
+    // Re-parses changed presets into 'configs'; one entry per overlay that changed.
+    // A preset that fails to parse or validate (e.g. half-saved) keeps its
+    // previous version; validator findings are printed with line and column.
+    void Poll(std::map<int, OverlayConfig>& configs, std::vector<PresetReload>& reloads);
+
+    // Turns 'live' into 'updated' with element-level edits, recorded in 'changes'.
+    // Elements are matched by id (by index when ids are missing or repeated);
+    // unchanged elements are left alone. Returns false if the elements were
+    // reordered or could not be matched, in which case 'live' is replaced whole.
+    static bool ApplyDiff(OverlayConfig& live, OverlayConfig&& updated, std::vector<ConfigChange>& changes);
+    static bool ElementsEqual(const OverlayElement& a, const OverlayElement& b);
+
+private:
+    struct TrackedPreset
+    {
+        std::string presetPath;
+        std::string texturePath;  // Empty if the preset has no texture
+        std::vector<std::string> dependencies;
+    };
+
+    FileWatcher m_watcher;
+    ConfigParser m_parser;
+    std::map<int, TrackedPreset> m_tracked;
+
+    // Textures are named relative to the preset when they exist there
+    static std::string ResolveTexturePath(const std::string& presetPath, const std::string& textureFile);
+    static bool HasUniqueIds(const std::vector<OverlayElement>& elements);
+    void SetDependencies(TrackedPreset& tracked, const std::vector<std::string>& dependencies);
+};
\ No newline at end of file
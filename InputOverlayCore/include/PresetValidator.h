@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Common.h"
+#include "JSONDocument.h"
+
+// One finding of PresetValidator, positioned in the preset text
+struct PresetIssue
+{
+    enum class Severity
+    {
+        Warning,  // Loads, but probably not as intended (sprite off the texture, duplicate id)
+        Error     // Wrong type or shape; the parser would fall back to a default
+    };
+
+    Severity severity;
+    int line;
+    int column;
+    std::string message;
+};
+
+// Checks presets against the native schema (see Presets/README.md).
+//
+// ConfigParser is lenient: a value of the wrong type falls back to a default
+// and the preset still loads. The validator reports those cases as errors with
+// their line and column, and warns about sprite rects outside the texture and
+// elements outside the canvas. Texture bounds come from texture.size, or from
+// the PNG header of the texture beside the preset when no size is given.
+// OBS presets are imported and only bounds-checked.
+class PresetValidator
+{
+public:
+    struct FileReport
+    {
+        std::string path;
+        std::vector<PresetIssue> issues;
+        bool valid = false;
+    };
+
+    // Parse and check one preset; false if it has errors (warnings alone pass).
+    // presetPath is used to find the texture and may be empty.
+    bool ValidateText(std::string_view json, const std::string& presetPath, std::vector<PresetIssue>& issues);
+    bool ValidateFile(const std::string& path, std::vector<PresetIssue>& issues);
+
+    // Checks an already parsed preset
+    static bool ValidateDocument(const JSONDocument& document, const std::string& presetPath, std::vector<PresetIssue>& issues);
+
+    // Validates every .json under 'directory' on 'threadCount' threads (0 = one
+    // per core). Reports are sorted by path; returns how many files are invalid.
+    static size_t ValidateDirectory(const std::string& directory, std::vector<FileReport>& reports, unsigned threadCount = 0);
+
+    // "path:line:column: error: message", one issue per line
+    static void PrintIssues(const std::string& path, const std::vector<PresetIssue>& issues);
+
+private:
+    JSONDocument m_document; // Reused between files to keep its buffers
+};
\ No newline at end of file
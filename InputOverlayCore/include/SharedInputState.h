@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Common.h"
+#include "KeyState.h"
+#include <atomic>
+
+// Latest input state as local readers see it. Filled by the core once per
+// frame; every field is plain data so other languages can mirror it.
+struct InputStateSnapshot
+{
+    uint64_t timestampNs;   // GetInputTimestampNs() of the frame it describes
+    uint64_t keysChangedNs; // Time of the last key or button edge, from the input journal
+    uint64_t keys[KeyStateSet::WORD_COUNT];        // Bit n = virtual key n, mouse buttons included
+    uint64_t keysLatched[KeyStateSet::WORD_COUNT]; // Went down during the frame, even if released again
+
+    // Running totals since the core started; the difference between two
+    // reads is the exact movement in between, however often a reader polls
+    int64_t totalDeltaX;
+    int64_t totalDeltaY;
+    int64_t totalWheel;
+
+    int32_t mouseX;     // Cursor position
+    int32_t mouseY;
+    int32_t deltaX;     // Relative movement during the frame
+    int32_t deltaY;
+    int32_t wheelDelta; // Wheel during the frame
+    int32_t reserved;
+};
+
+static_assert(sizeof(InputStateSnapshot) == 128, "InputStateSnapshot layout is shared with other processes");
+
+// Publishes InputStateSnapshots through a small named shared-memory region
+// (INPUT_STATE_NAME) guarded by a seqlock, so any local process reads the
+// latest state without serialization, syscalls or waiting on the writer.
+//
+// Region layout (little endian):
+//   0   char magic[4]      "AIOS"
+//   4   uint16_t version   STATE_VERSION
+//   6   uint16_t dataOffset
+//   8   uint32_t dataSize  sizeof(InputStateSnapshot)
+//   12  uint32_t sequence  Odd while an update is in progress
+//   16  snapshot, as 32-bit words
+// To read: load sequence, copy the snapshot, load sequence again, and retry
+// if the two differ or are odd.
+class SharedInputState
+{
+public:
+    static const uint16_t STATE_VERSION = 1;
+
+    SharedInputState();
+    ~SharedInputState();
+
+    SharedInputState(const SharedInputState&) = delete;
+    SharedInputState& operator=(const SharedInputState&) = delete;
+
+    // Writer: creates the region, replacing one left behind by a crash
+    bool Create(const std::string& name = INPUT_STATE_NAME);
+
+    // Reader: maps an existing region read-only; false without logging if
+    // the core is not running
+    bool Open(const std::string& name = INPUT_STATE_NAME);
+    void Close();
+
+    bool IsOpen() const { return m_block != nullptr; }
+
+    void Publish(const InputStateSnapshot& state);
+
+    // Copies the latest complete snapshot. False if not open, or if the
+    // writer stayed mid-update for the whole retry budget (it died there).
+    bool Read(InputStateSnapshot& state) const;
+
+    // Advances by 2 per Publish(); readers can skip Read() while unchanged
+    uint32_t GetSequence() const;
+
+private:
+    static const int WORD_COUNT = sizeof(InputStateSnapshot) / sizeof(uint32_t);
+
+    struct Block
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t dataOffset;
+        uint32_t dataSize;
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> words[WORD_COUNT]; // Relaxed atomics, so concurrent reads are well defined
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "The seqlock needs plain 32-bit loads and stores");
+    static_assert(sizeof(Block) == 16 + sizeof(InputStateSnapshot), "Block layout is shared with other processes");
+
+    Block* m_block;
+    bool m_isWriter;
+    std::string m_name;
+
+#ifdef _WIN32
+    HANDLE m_hMapping;
+#endif
+
+    bool Map(const std::string& name, bool create);
+};
\ No newline at end of file
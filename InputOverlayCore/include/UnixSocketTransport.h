@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IPCTransport.h"
+
+#ifdef __linux__
+
+#include <atomic>
+#include <mutex>
+
+// Linux transport over a SOCK_SEQPACKET Unix domain socket, which keeps
+// message boundaries like the Windows message-mode pipe. The server listens
+// on DefaultPath() and serves one client at a time; a client transport
+// connects to it, so a test client exchanges the same IPCMessages as the UI.
+// Blocking calls wait in poll() together with an eventfd that Shutdown()
+// signals.
+class UnixSocketTransport : public IPCTransport
+{
+public:
+    enum class Role
+    {
+        Server,
+        Client
+    };
+
+    explicit UnixSocketTransport(const std::string& path = DefaultPath(), Role role = Role::Server);
+    ~UnixSocketTransport() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+    const char* GetName() const override { return "unix socket"; }
+
+    bool WaitForClient() override;
+    void Disconnect() override;
+    bool Read(std::string& message) override;
+    bool Write(const std::string& message) override;
+
+    // $XDG_RUNTIME_DIR/<IPC_SOCKET_NAME>, or /tmp when that is not set
+    static std::string DefaultPath();
+
+private:
+    std::string m_path;
+    Role m_role;
+    int m_listenFd;
+    std::atomic<int> m_clientFd;
+    int m_wakeFd;
+    std::atomic<bool> m_shouldStop;
+    std::mutex m_readMutex;  // Held by Read() and Write() while they use the client
+    std::mutex m_writeMutex; // socket, so Disconnect() never closes it under them
+
+    // Waits until 'fd' has 'events' or Shutdown() is called
+    bool WaitFor(int fd, short events);
+    bool Listen();
+    bool Connect();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "InputBackend.h"
+#include "MouseAccumulator.h"
+
+#ifdef _WIN32
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// Windows backend.
+// Keyboard, mouse buttons, raw mouse motion and wheel arrive as Raw Input
+// (WM_INPUT) on a capture thread with a message-only window, so every edge is
+// recorded with its own timestamp and motion is summed at device rate even
+// while another application has focus or the cursor is locked. Only the
+// on-screen cursor position is sampled via GetCursorPos() on every Poll().
+class Win32InputBackend : public InputBackend
+{
+public:
+    Win32InputBackend();
+    ~Win32InputBackend() override;
+
+    bool Initialize() override;
+    void Shutdown() override;
+    const char* GetName() const override { return "win32"; }
+    void Poll(std::vector<InputEvent>& events) override;
+
+private:
+    HINSTANCE m_hInstance;
+
+    // Raw Input capture thread
+    std::thread m_captureThread;
+    std::atomic<DWORD> m_captureThreadId;
+    HWND m_captureWindow;
+
+    // Edges captured by the thread, handed over in Poll()
+    std::vector<InputEvent> m_capturedEvents;
+    std::mutex m_capturedMutex;
+    MouseAccumulator m_mouse;
+
+    // Last reported state per key, used to drop autorepeat (capture thread only)
+    bool m_keyDown[256];
+
+    // Previous report of absolute-mode devices (tablets, remote desktop), capture thread only
+    POINT m_lastAbsoluteMouse;
+    bool m_hasAbsoluteMouse;
+
+    bool StartCaptureThread();
+    void CaptureThreadFunc(std::promise<bool>* started);
+    void HandleRawInput(HRAWINPUT rawInput);
+    void CaptureKey(uint64_t timestamp, int virtualKey, bool down);
+    void HandleRawMouse(uint64_t timestamp, const RAWMOUSE& mouse);
+    void PollCursorPosition(std::vector<InputEvent>& events, uint64_t timestamp);
+};
+
+#endif
\ No newline at end of file
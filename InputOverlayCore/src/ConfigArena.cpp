@@ -0,0 +1,88 @@
+#include "../include/ConfigArena.h"
+#include <cstring>
+
+void* ConfigArena::CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+    ++blockCount;
+    reservedBytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void ConfigArena::CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+ConfigArena::ConfigArena(size_t expectedStrings)
+    : m_arena(MIN_BLOCK_SIZE + expectedStrings * BYTES_PER_STRING, &m_upstream)
+    , m_strings(&m_arena)
+{
+    if (expectedStrings > 0)
+        m_strings.reserve(expectedStrings);
+}
+
+ConfigArena& ConfigArena::Of(OverlayConfig& config, size_t expectedStrings)
+{
+    if (!config.arena)
+        config.arena = std::make_shared<ConfigArena>(expectedStrings);
+    return *config.arena;
+}
+
+std::string_view ConfigArena::Intern(std::string_view text)
+{
+    if (text.empty())
+        return std::string_view();
+
+    auto it = m_strings.find(text);
+    if (it != m_strings.end())
+        return *it;
+
+    char* copy = static_cast<char*>(m_arena.allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+
+    std::string_view interned(copy, text.size());
+    m_strings.insert(interned);
+    return interned;
+}
+
+void ConfigArena::Adopt(OverlayElement& element)
+{
+    element.id = Intern(element.id);
+    element.key.id = Intern(element.key.id);
+    element.cursor.mode = Intern(element.cursor.mode);
+}
+
+bool ConfigArena::Compact(OverlayConfig& config)
+{
+    if (!config.arena)
+        return false;
+
+    size_t strings = 0;
+    size_t characters = 0;
+    auto count = [&](std::string_view text)
+    {
+        strings += text.empty() ? 0 : 1;
+        characters += text.size();
+    };
+    for (const auto& element : config.elements)
+    {
+        count(element.id);
+        count(element.cursor.mode);
+
+        // Usually the same interned text as the id
+        if (element.key.id.data() != element.id.data())
+            count(element.key.id);
+    }
+
+    size_t needed = MIN_BLOCK_SIZE + strings * BYTES_PER_STRING + characters;
+    if (config.arena->GetReservedBytes() <= 2 * needed)
+        return false;
+
+    auto fresh = std::make_shared<ConfigArena>(strings);
+    for (auto& element : config.elements)
+    {
+        fresh->Adopt(element);
+    }
+    config.arena = std::move(fresh);
+    return true;
+}
\ No newline at end of file
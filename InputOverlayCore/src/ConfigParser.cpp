@@ -1,9 +1,17 @@
 #include "../include/ConfigParser.h"
+#include "../include/KeyCodes.h"
+#include "../include/PresetCache.h"
+#include "../include/MappedFile.h"
+#include "../include/OBSPresetImporter.h"
+#include "../include/PresetValidator.h"
 #include <iostream>
 #include <algorithm>
-#include <regex>
+#include <cstdio>
+#include <filesystem>
 
 ConfigParser::ConfigParser()
+    : m_cacheEnabled(true)
+    , m_strictValidation(false)
 {
 }
 
@@ -13,239 +21,641 @@ ConfigParser::~ConfigParser()
 
 bool ConfigParser::ParseConfigFromFile(const std::string& filePath, OverlayConfig& config)
 {
-    std::ifstream file(filePath);
-    if (!file.is_open())
+    MappedFile file;
+    if (!file.Open(filePath))
     {
         std::cerr << "Failed to open config file: " << filePath << std::endl;
         return false;
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string jsonContent = buffer.str();
-    file.close();
-
-    return ParseConfigFromJSON(jsonContent, config);
+    std::string_view jsonContent(reinterpret_cast<const char*>(file.Data()), file.Size());
+    return ParseWithCache(jsonContent, PresetCache::CachePathFor(filePath), filePath, config);
 }
 
 bool ConfigParser::ParseFromString(const std::string& jsonString, OverlayConfig& config)
 {
-    return ParseConfigFromJSON(jsonString, config);
+    return ParseWithCache(jsonString, m_cacheDirectory, "", config);
 }
 
-bool ConfigParser::ParseConfigFromJSON(const std::string& jsonString, OverlayConfig& config)
+void ConfigParser::SetCacheDirectory(const std::string& directory)
 {
-    try
+    m_cacheDirectory = directory;
+    if (directory.empty())
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
     {
-        // Parse version
-        config.version = JSONUtils::ExtractIntValue(jsonString, "version");
-        if (config.version == 0) config.version = 1; // Default
+        std::cerr << "Failed to create preset cache directory " << directory << ": " << error.message() << std::endl;
+        m_cacheDirectory.clear();
+    }
+}
+
+bool ConfigParser::ParseWithCache(std::string_view jsonString, const std::string& cachePath,
+                                  const std::string& sourcePath, OverlayConfig& config)
+{
+    m_dependencies.clear();
+
+    // Strict validation needs the document, so it never loads from the cache;
+    // a preset that passes still refreshes it for the next non-strict load
+    bool useCache = m_cacheEnabled && !cachePath.empty();
+    uint64_t hash = useCache ? PresetCache::HashText(jsonString) : 0;
+
+    // Text configs have no file of their own; cachePath names the directory
+    std::string cacheFile = cachePath;
+    if (useCache && sourcePath.empty())
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.aiocache", static_cast<unsigned long long>(hash));
+        cacheFile = cachePath + "/" + name;
+    }
+
+    if (useCache && !m_strictValidation && PresetCache::Load(cacheFile, hash, config))
+    {
+        ResolveKeyBindings(config);
+        return true;
+    }
+
+    if (!ParseConfigFromJSON(jsonString, config, sourcePath))
+        return false;
 
-        // Parse texture section
-        std::string textureJson = JSONUtils::ExtractValue(jsonString, "texture");
-        if (!textureJson.empty())
+    if (m_strictValidation)
+    {
+        std::vector<PresetIssue> issues;
+        bool valid = PresetValidator::ValidateDocument(m_document, sourcePath, issues);
+        PresetValidator::PrintIssues(sourcePath.empty() ? "<config>" : sourcePath, issues);
+        if (!valid)
+            return false;
+    }
+
+    // OBS presets do not name their texture; it sits beside the file
+    if (config.textureFile.empty() && !sourcePath.empty())
+    {
+        config.textureFile = OBSPreset::FindTextureFile(sourcePath);
+    }
+
+    // A read-only preset folder just means no cache. Composed presets depend
+    // on more than their own text, which is all the cache key covers.
+    if (useCache && m_dependencies.empty())
+    {
+        PresetCache::Save(cacheFile, hash, config);
+    }
+    return true;
+}
+
+bool ConfigParser::ParseConfigFromJSON(std::string_view jsonString, OverlayConfig& config, const std::string& sourcePath)
+{
+    if (m_loading.empty())
+        m_dependencies.clear();
+
+    if (!m_document.Parse(jsonString))
+    {
+        int line = 0;
+        int column = 0;
+        m_document.GetLineColumn(m_document.GetErrorOffset(), line, column);
+        std::cerr << "JSON parsing error at line " << line << ", column " << column
+                  << ": " << m_document.GetError() << std::endl;
+        return false;
+    }
+
+    JSONValue root = m_document.Root();
+    if (!root.IsObject())
+    {
+        std::cerr << "JSON parsing error: configuration must be an object" << std::endl;
+        return false;
+    }
+
+    if (OBSPreset::IsOBSPreset(root))
+    {
+        if (!OBSPreset::Import(root, config))
+            return false;
+
+        ResolveKeyBindings(config);
+        return true;
+    }
+
+    // Parents and includes first; every section below overrides them
+    size_t inheritedCount = 0;
+    if (root.HasMember("extends") || root.HasMember("include"))
+    {
+        if (!ComposeParts(root, sourcePath, config))
+            return false;
+
+        root = m_document.Root();
+        inheritedCount = config.elements.size();
+    }
+
+    // Parse version
+    config.version = root["version"].AsInt(config.version);
+    if (config.version == 0) config.version = 1; // Default
+
+    // Parse texture section
+    JSONValue texture = root["texture"];
+    if (texture.IsObject())
+    {
+        ParseTexture(texture, config);
+    }
+
+    // Parse canvas section
+    JSONValue canvas = root["canvas"];
+    if (canvas.IsObject())
+    {
+        ParseCanvas(canvas, config);
+    }
+
+    // Parse defaults section
+    JSONValue defaults = root["defaults"];
+    if (defaults.IsObject())
+    {
+        ParseDefaults(defaults, config);
+    }
+
+    // Parse elements array
+    JSONValue elements = root["elements"];
+    if (elements.IsArray())
+    {
+        ParseElements(elements, config, inheritedCount);
+    }
+
+    // Inherited elements take this preset's pressed offset
+    if (inheritedCount > 0)
+    {
+        for (auto& element : config.elements)
         {
-            ParseTexture(textureJson, config);
+            element.sprite.ResolveStates(config.defaultPressedOffset);
         }
+    }
 
-        // Parse canvas section
-        std::string canvasJson = JSONUtils::ExtractValue(jsonString, "canvas");
-        if (!canvasJson.empty())
+    ResolveKeyBindings(config);
+    return true;
+}
+
+bool ConfigParser::ApplyPatch(std::string_view patchJson, OverlayConfig& config, std::vector<ConfigChange>& changes)
+{
+    if (!m_document.Parse(patchJson))
+    {
+        int line = 0;
+        int column = 0;
+        m_document.GetLineColumn(m_document.GetErrorOffset(), line, column);
+        std::cerr << "Config patch error at line " << line << ", column " << column
+                  << ": " << m_document.GetError() << std::endl;
+        return false;
+    }
+
+    JSONValue ops = m_document.Root()["ops"];
+    if (!ops.IsArray())
+    {
+        std::cerr << "Config patch error: patch must be an object with an \"ops\" array" << std::endl;
+        return false;
+    }
+
+    bool applied = true;
+    for (JSONValue op : ops)
+    {
+        std::string_view kind = op["op"].AsStringView();
+        size_t index = 0;
+        const char* error = nullptr;
+
+        if (kind == "add")
         {
-            ParseCanvas(canvasJson, config);
-        }
+            index = config.elements.size();
+            JSONValue at = op["index"];
+            if (at.IsValid())
+            {
+                int requested = at.AsInt(-1);
+                if (requested < 0 || static_cast<size_t>(requested) > config.elements.size())
+                    error = "insert index out of range";
+                else
+                    index = static_cast<size_t>(requested);
+            }
 
-        // Parse defaults section
-        std::string defaultsJson = JSONUtils::ExtractValue(jsonString, "defaults");
-        if (!defaultsJson.empty())
+            if (!error)
+            {
+                OverlayElement element;
+                ParseElement(op, element, config);
+                element.key.stateIndex = static_cast<uint8_t>(KeyCodes::ResolveInputKey(element.key));
+
+                config.keyStateIndices.insert(config.keyStateIndices.begin() + index, element.key.stateIndex);
+                config.elements.insert(config.elements.begin() + index, std::move(element));
+                changes.push_back({ ConfigChange::Kind::Add, index });
+            }
+        }
+        else if (kind == "update" || kind == "remove")
+        {
+            if (!FindPatchTarget(op, config, index))
+            {
+                error = "no element with that index or id";
+            }
+            else if (kind == "update")
+            {
+                OverlayElement& element = config.elements[index];
+                ParseElement(op, element, config);
+                element.key.stateIndex = static_cast<uint8_t>(KeyCodes::ResolveInputKey(element.key));
+                config.keyStateIndices[index] = element.key.stateIndex;
+                changes.push_back({ ConfigChange::Kind::Update, index });
+            }
+            else
+            {
+                config.keyStateIndices.erase(config.keyStateIndices.begin() + index);
+                config.elements.erase(config.elements.begin() + index);
+                changes.push_back({ ConfigChange::Kind::Remove, index });
+            }
+        }
+        else
         {
-            ParseDefaults(defaultsJson, config);
+            error = "unknown op, expected \"update\", \"add\" or \"remove\"";
         }
 
-        // Parse elements array
-        std::string elementsJson = JSONUtils::ExtractValue(jsonString, "elements");
-        if (!elementsJson.empty())
+        // A bad op is skipped; the ones around it still apply
+        if (error)
         {
-            ParseElements(elementsJson, config);
+            int line = 0;
+            int column = 0;
+            m_document.GetLineColumn(op.GetOffset(), line, column);
+            std::cerr << "Config patch error at line " << line << ", column " << column
+                      << ": " << error << std::endl;
+            applied = false;
         }
+    }
+
+    // The arena is monotonic; without this, a long session of add/remove
+    // patches would grow it until the overlay is removed
+    ConfigArena::Compact(config);
+    return applied;
+}
 
+bool ConfigParser::FindPatchTarget(const JSONValue& op, const OverlayConfig& config, size_t& index)
+{
+    JSONValue at = op["index"];
+    if (at.IsNumber())
+    {
+        int requested = at.AsInt(-1);
+        if (requested < 0 || static_cast<size_t>(requested) >= config.elements.size())
+            return false;
+
+        index = static_cast<size_t>(requested);
         return true;
     }
-    catch (const std::exception& e)
-    {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
+
+    std::string_view id = op["id"].AsStringView();
+    if (id.empty())
         return false;
+
+    for (size_t i = 0; i < config.elements.size(); ++i)
+    {
+        if (config.elements[i].id == id)
+        {
+            index = i;
+            return true;
+        }
     }
+    return false;
 }
 
-bool ConfigParser::ParseTexture(const std::string& textureJson, OverlayConfig& config)
+bool ConfigParser::ParseTexture(const JSONValue& texture, OverlayConfig& config)
 {
-    config.textureFile = JSONUtils::ExtractStringValue(textureJson, "file");
+    config.textureFile = texture["file"].AsString(config.textureFile);
 
-    auto sizeArray = JSONUtils::ExtractIntArray(textureJson, "size");
-    if (sizeArray.size() >= 2)
+    int size[2];
+    if (texture["size"].GetInts(size, 2) == 2)
     {
-        config.textureSize.x = sizeArray[0];
-        config.textureSize.y = sizeArray[1];
+        config.textureSize.x = size[0];
+        config.textureSize.y = size[1];
     }
 
     return true;
 }
 
-bool ConfigParser::ParseCanvas(const std::string& canvasJson, OverlayConfig& config)
+bool ConfigParser::ParseCanvas(const JSONValue& canvas, OverlayConfig& config)
 {
-    auto sizeArray = JSONUtils::ExtractIntArray(canvasJson, "size");
-    if (sizeArray.size() >= 2)
+    int size[2];
+    if (canvas["size"].GetInts(size, 2) == 2)
     {
-        config.canvasSize.x = sizeArray[0];
-        config.canvasSize.y = sizeArray[1];
+        config.canvasSize.x = size[0];
+        config.canvasSize.y = size[1];
     }
 
-    auto bgArray = JSONUtils::ExtractIntArray(canvasJson, "background");
-    if (bgArray.size() >= 4)
+    int background[4];
+    if (canvas["background"].GetInts(background, 4) == 4)
     {
         config.backgroundColor = Color(
-            static_cast<unsigned char>(bgArray[0]),
-            static_cast<unsigned char>(bgArray[1]),
-            static_cast<unsigned char>(bgArray[2]),
-            static_cast<unsigned char>(bgArray[3])
+            static_cast<unsigned char>(background[0]),
+            static_cast<unsigned char>(background[1]),
+            static_cast<unsigned char>(background[2]),
+            static_cast<unsigned char>(background[3])
         );
     }
 
     return true;
 }
 
-bool ConfigParser::ParseDefaults(const std::string& defaultsJson, OverlayConfig& config)
+bool ConfigParser::ParseDefaults(const JSONValue& defaults, OverlayConfig& config)
 {
-    auto offsetArray = JSONUtils::ExtractIntArray(defaultsJson, "pressed_offset");
-    if (offsetArray.size() >= 2)
+    int offset[2];
+    if (defaults["pressed_offset"].GetInts(offset, 2) == 2)
     {
-        config.defaultPressedOffset.x = offsetArray[0];
-        config.defaultPressedOffset.y = offsetArray[1];
+        config.defaultPressedOffset.x = offset[0];
+        config.defaultPressedOffset.y = offset[1];
     }
 
+    config.latchTaps = defaults["latch_taps"].AsBool(config.latchTaps);
+    config.minPressDurationMs = std::max(0, defaults["min_press_ms"].AsInt(config.minPressDurationMs));
+
     return true;
 }
 
-bool ConfigParser::ParseElements(const std::string& elementsJson, OverlayConfig& config)
+bool ConfigParser::ParseElements(const JSONValue& elements, OverlayConfig& config, size_t inheritedCount)
 {
-    // Remove array brackets and split by elements
-    std::string cleanJson = elementsJson;
-    if (cleanJson.front() == '[') cleanJson.erase(0, 1);
-    if (cleanJson.back() == ']') cleanJson.pop_back();
+    config.elements.reserve(config.elements.size() + elements.Size());
+    ConfigArena::Of(config, elements.Size()); // Sized before the first id is interned
 
-    auto elementStrings = JSONUtils::SplitArray(cleanJson);
+    // In a composed preset, an element with an inherited id edits that
+    // element, or drops it with "remove": true
+    std::map<std::string_view, size_t> inherited;
+    for (size_t i = 0; i < inheritedCount; ++i)
+    {
+        if (!config.elements[i].id.empty())
+            inherited.emplace(config.elements[i].id, i);
+    }
+    std::vector<bool> removed(inheritedCount, false);
 
-    for (const auto& elementStr : elementStrings)
+    for (JSONValue elementJson : elements)
     {
+        if (!elementJson.IsObject())
+            continue;
+
+        if (!inherited.empty())
+        {
+            auto match = inherited.find(elementJson["id"].AsStringView());
+            if (match != inherited.end())
+            {
+                if (elementJson["remove"].AsBool(false))
+                    removed[match->second] = true;
+                else
+                    ParseElement(elementJson, config.elements[match->second], config);
+                continue;
+            }
+        }
+
         OverlayElement element;
-        if (ParseElement(elementStr, element))
+        if (ParseElement(elementJson, element, config))
+        {
+            config.elements.push_back(std::move(element));
+        }
+    }
+
+    for (size_t i = inheritedCount; i-- > 0; )
+    {
+        if (removed[i])
+            config.elements.erase(config.elements.begin() + i);
+    }
+
+    return true;
+}
+
+bool ConfigParser::ComposeParts(const JSONValue& root, const std::string& sourcePath, OverlayConfig& config)
+{
+    // Names are relative to the preset that uses them
+    std::filesystem::path directory = std::filesystem::path(sourcePath).parent_path();
+    auto resolve = [&](std::string_view name)
+    {
+        return (directory / std::filesystem::path(std::string(name))).lexically_normal().string();
+    };
+
+    std::string parentPath;
+    JSONValue extends = root["extends"];
+    if (extends.IsString())
+        parentPath = resolve(extends.AsStringView());
+
+    std::vector<std::string> includePaths;
+    JSONValue include = root["include"];
+    if (include.IsString())
+        includePaths.push_back(resolve(include.AsStringView()));
+    for (JSONValue item : include)
+    {
+        if (item.IsString())
+            includePaths.push_back(resolve(item.AsStringView()));
+    }
+    size_t ownElements = root["elements"].Size();
+
+    // Parts are parsed with m_document; keep this preset's tape aside meanwhile
+    JSONDocument preset = std::move(m_document);
+    bool composed = true;
+
+    if (!parentPath.empty())
+    {
+        const ComposedPart* parent = LoadPart(parentPath);
+        if (parent)
+            config = parent->config;
+        else
+            composed = false;
+    }
+
+    for (size_t i = 0; i < includePaths.size() && composed; ++i)
+    {
+        const ComposedPart* part = LoadPart(includePaths[i]);
+        if (!part)
         {
-            config.elements.push_back(element);
+            composed = false;
+            continue;
+        }
+
+        // Included elements replace earlier ones with the same id, the rest are appended
+        for (const OverlayElement& element : part->config.elements)
+        {
+            auto existing = std::find_if(config.elements.begin(), config.elements.end(),
+                [&](const OverlayElement& e) { return !element.id.empty() && e.id == element.id; });
+            if (existing != config.elements.end())
+                *existing = element;
+            else
+                config.elements.push_back(element);
         }
     }
 
+    m_document = std::move(preset);
+    if (!composed)
+        return false;
+
+    // The flat result owns its strings; cached parts are never modified
+    auto arena = std::make_shared<ConfigArena>(config.elements.size() + ownElements);
+    for (auto& element : config.elements)
+    {
+        arena->Adopt(element);
+    }
+    config.arena = std::move(arena);
     return true;
 }
 
-bool ConfigParser::ParseElement(const std::string& elementJson, OverlayElement& element)
+const ConfigParser::ComposedPart* ConfigParser::LoadPart(const std::string& path)
 {
-    element.id = JSONUtils::ExtractStringValue(elementJson, "id");
+    if (std::find(m_loading.begin(), m_loading.end(), path) != m_loading.end())
+    {
+        std::cerr << "Preset " << path << " is part of an extends/include cycle" << std::endl;
+        return nullptr;
+    }
+
+    std::error_code error;
+    auto cached = m_parts.find(path);
+    if (cached != m_parts.end())
+    {
+        bool current = true;
+        for (const auto& [file, writeTime] : cached->second.files)
+        {
+            if (std::filesystem::last_write_time(file, error) != writeTime || error)
+            {
+                current = false;
+                break;
+            }
+        }
+
+        if (current)
+        {
+            for (const auto& file : cached->second.files)
+            {
+                m_dependencies.push_back(file.first);
+            }
+            return &cached->second;
+        }
+    }
+
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    MappedFile file;
+    if (error || !file.Open(path))
+    {
+        std::cerr << "Failed to open preset part: " << path << std::endl;
+        return nullptr;
+    }
+
+    ComposedPart part;
+    size_t firstFile = m_dependencies.size();
+    m_dependencies.push_back(path);
+
+    m_loading.push_back(path);
+    std::string_view json(reinterpret_cast<const char*>(file.Data()), file.Size());
+    bool parsed = ParseConfigFromJSON(json, part.config, path);
+    m_loading.pop_back();
+
+    if (!parsed)
+    {
+        std::cerr << "Failed to parse preset part: " << path << std::endl;
+        return nullptr;
+    }
+
+    // The nested parse appended the files of this part's own parts
+    part.files.emplace_back(path, writeTime);
+    for (size_t i = firstFile + 1; i < m_dependencies.size(); ++i)
+    {
+        part.files.emplace_back(m_dependencies[i], std::filesystem::last_write_time(m_dependencies[i], error));
+    }
+
+    ComposedPart& stored = m_parts[path];
+    stored = std::move(part);
+    return &stored;
+}
+
+void ConfigParser::ResolveKeyBindings(OverlayConfig& config)
+{
+    config.keyStateIndices.resize(config.elements.size());
+    for (size_t i = 0; i < config.elements.size(); ++i)
+    {
+        InputKey& key = config.elements[i].key;
+        key.stateIndex = static_cast<uint8_t>(KeyCodes::ResolveInputKey(key));
+        config.keyStateIndices[i] = key.stateIndex;
+    }
+}
+
+bool ConfigParser::ParseElement(const JSONValue& elementJson, OverlayElement& element, OverlayConfig& config)
+{
+    ConfigArena& arena = ConfigArena::Of(config);
+
+    // Missing fields keep the element's current value, so the same code parses
+    // new elements and applies partial updates from patches
+    JSONValue id = elementJson["id"];
+    if (id.IsString())
+        element.id = arena.Intern(id.AsStringView());
 
     // Parse codes
-    std::string codesJson = JSONUtils::ExtractValue(elementJson, "codes");
-    ParseCodes(codesJson, element.key);
+    ParseCodes(elementJson["codes"], element.key);
 
     // Parse position
-    auto posArray = JSONUtils::ExtractIntArray(elementJson, "pos");
-    if (posArray.size() >= 2)
+    int position[2];
+    if (elementJson["pos"].GetInts(position, 2) == 2)
     {
-        element.position.x = posArray[0];
-        element.position.y = posArray[1];
+        element.position.x = position[0];
+        element.position.y = position[1];
     }
 
     // Parse sprite
-    std::string spriteJson = JSONUtils::ExtractValue(elementJson, "sprite");
-    ParseSprite(spriteJson, element.sprite, Vector2i(0, 0)); // Will use global default if needed
+    ParseSprite(elementJson["sprite"], element.sprite);
+    element.sprite.ResolveStates(config.defaultPressedOffset);
 
     // Parse z-order
-    element.zOrder = JSONUtils::ExtractIntValue(elementJson, "z");
+    element.zOrder = elementJson["z"].AsInt(element.zOrder);
 
     // Parse wheel property
-    std::string wheelValue = JSONUtils::ExtractValue(elementJson, "wheel");
-    element.isWheel = (wheelValue == "true");
+    element.isWheel = elementJson["wheel"].AsBool(element.isWheel);
 
     // Parse cursor property
-    std::string cursorJson = JSONUtils::ExtractValue(elementJson, "cursor");
-    if (!cursorJson.empty())
+    JSONValue cursorJson = elementJson["cursor"];
+    if (cursorJson.IsObject())
     {
-        ParseCursor(cursorJson, element.cursor);
+        ParseCursor(cursorJson, element.cursor, arena);
     }
 
     return true;
 }
 
-bool ConfigParser::ParseCodes(const std::string& codesJson, InputKey& key)
+bool ConfigParser::ParseCodes(const JSONValue& codes, InputKey& key)
 {
-    key.hid = JSONUtils::ExtractIntValue(codesJson, "hid");
-    key.winvk = JSONUtils::ExtractIntValue(codesJson, "winvk");
-    key.evdev = JSONUtils::ExtractIntValue(codesJson, "evdev");
+    key.hid = codes["hid"].AsInt(key.hid);
+    key.winvk = codes["winvk"].AsInt(key.winvk);
+    key.evdev = codes["evdev"].AsInt(key.evdev);
 
     return true;
 }
 
-bool ConfigParser::ParseSprite(const std::string& spriteJson, SpriteInfo& sprite, const Vector2i& defaultOffset)
+bool ConfigParser::ParseSprite(const JSONValue& spriteJson, SpriteInfo& sprite)
 {
+    int rect[4];
+
     // Parse normal sprite rect
-    auto normalArray = JSONUtils::ExtractIntArray(spriteJson, "normal");
-    if (normalArray.size() >= 4)
+    if (spriteJson["normal"].GetInts(rect, 4) == 4)
     {
-        sprite.normal = IntRect(normalArray[0], normalArray[1], normalArray[2], normalArray[3]);
+        sprite.normal = IntRect(rect[0], rect[1], rect[2], rect[3]);
     }
 
     // Parse pressed sprite rect (optional)
-    auto pressedArray = JSONUtils::ExtractIntArray(spriteJson, "pressed");
-    if (pressedArray.size() >= 4)
-    {
-        sprite.pressed = IntRect(pressedArray[0], pressedArray[1], pressedArray[2], pressedArray[3]);
-        sprite.hasPressedState = true;
-    }
-    else if (defaultOffset.x != 0 || defaultOffset.y != 0)
+    if (spriteJson["pressed"].GetInts(rect, 4) == 4)
     {
-        // Use default offset
-        sprite.pressed = IntRect(
-            sprite.normal.left + defaultOffset.x,
-            sprite.normal.top + defaultOffset.y,
-            sprite.normal.width,
-            sprite.normal.height
-        );
+        sprite.pressed = IntRect(rect[0], rect[1], rect[2], rect[3]);
         sprite.hasPressedState = true;
     }
 
     // Parse up sprite rect (for wheel scroll up)
-    auto upArray = JSONUtils::ExtractIntArray(spriteJson, "up");
-    if (upArray.size() >= 4)
+    if (spriteJson["up"].GetInts(rect, 4) == 4)
     {
-        sprite.up = IntRect(upArray[0], upArray[1], upArray[2], upArray[3]);
+        sprite.up = IntRect(rect[0], rect[1], rect[2], rect[3]);
         sprite.hasUpState = true;
     }
 
     // Parse down sprite rect (for wheel scroll down)
-    auto downArray = JSONUtils::ExtractIntArray(spriteJson, "down");
-    if (downArray.size() >= 4)
+    if (spriteJson["down"].GetInts(rect, 4) == 4)
     {
-        sprite.down = IntRect(downArray[0], downArray[1], downArray[2], downArray[3]);
+        sprite.down = IntRect(rect[0], rect[1], rect[2], rect[3]);
         sprite.hasDownState = true;
     }
 
     return true;
 }
 
-bool ConfigParser::ParseCursor(const std::string& cursorJson, CursorInfo& cursor)
+bool ConfigParser::ParseCursor(const JSONValue& cursorJson, CursorInfo& cursor, ConfigArena& arena)
 {
     cursor.enabled = true;
-    cursor.mode = JSONUtils::ExtractStringValue(cursorJson, "mode");
-    cursor.radius = JSONUtils::ExtractIntValue(cursorJson, "radius");
+    JSONValue mode = cursorJson["mode"];
+    if (mode.IsString())
+        cursor.mode = arena.Intern(mode.AsStringView());
+    cursor.radius = cursorJson["radius"].AsInt(cursor.radius);
 
     // Set default radius if not provided
     if (cursor.radius == 0)
@@ -254,192 +664,162 @@ bool ConfigParser::ParseCursor(const std::string& cursorJson, CursorInfo& cursor
     return true;
 }
 
-// JSON Utility Functions
-namespace JSONUtils
+bool ConfigParser::SaveConfigToFile(const std::string& filePath, const OverlayConfig& config)
 {
-    std::string ExtractValue(const std::string& json, const std::string& key)
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
     {
-        std::string value;
-        if (FindKeyValue(json, key, value))
-        {
-            return value;
-        }
-        return "";
+        std::cerr << "Failed to create config file: " << filePath << std::endl;
+        return false;
     }
 
-    std::string ExtractStringValue(const std::string& json, const std::string& key)
+    JSONWriter writer(file, true);
+    WriteConfig(writer, config);
+    if (!writer.Flush())
     {
-        std::string value = ExtractValue(json, key);
-        if (!value.empty() && value.front() == '"' && value.back() == '"')
-        {
-            value = value.substr(1, value.length() - 2); // Remove quotes
-        }
-        return value;
+        std::cerr << "Failed to write config file: " << filePath << std::endl;
+        return false;
     }
 
-    int ExtractIntValue(const std::string& json, const std::string& key)
-    {
-        std::string value = ExtractValue(json, key);
-        try
-        {
-            return std::stoi(value);
-        }
-        catch (...)
-        {
-            return 0;
-        }
-    }
+    return true;
+}
 
-    std::vector<int> ExtractIntArray(const std::string& json, const std::string& key)
-    {
-        std::vector<int> result;
-        std::string value = ExtractValue(json, key);
+std::string ConfigParser::ConfigToJSON(const OverlayConfig& config, bool pretty)
+{
+    std::string json;
+    json.reserve(256 + config.elements.size() * (pretty ? 320 : 200));
 
-        if (value.empty()) return result;
+    JSONWriter writer(json, pretty);
+    WriteConfig(writer, config);
+    writer.Flush();
+    return json;
+}
 
-        // Remove array brackets
-        if (value.front() == '[') value.erase(0, 1);
-        if (value.back() == ']') value.pop_back();
+void ConfigParser::WriteConfig(JSONWriter& writer, const OverlayConfig& config)
+{
+    writer.BeginObject();
+
+    writer.Key("version");
+    writer.Int(config.version);
+
+    writer.Key("texture");
+    writer.BeginObject();
+    writer.Key("file");
+    writer.String(config.textureFile);
+    writer.Key("size");
+    Vector2iToJSON(writer, config.textureSize);
+    writer.EndObject();
+
+    const int background[4] = { config.backgroundColor.r, config.backgroundColor.g,
+                                 config.backgroundColor.b, config.backgroundColor.a };
+    writer.Key("canvas");
+    writer.BeginObject();
+    writer.Key("size");
+    Vector2iToJSON(writer, config.canvasSize);
+    writer.Key("background");
+    writer.IntArray(background, 4);
+    writer.EndObject();
+
+    writer.Key("defaults");
+    writer.BeginObject();
+    writer.Key("pressed_offset");
+    Vector2iToJSON(writer, config.defaultPressedOffset);
+    writer.Key("latch_taps");
+    writer.Bool(config.latchTaps);
+    writer.Key("min_press_ms");
+    writer.Int(config.minPressDurationMs);
+    writer.EndObject();
+
+    writer.Key("elements");
+    writer.BeginArray();
+    for (const auto& element : config.elements)
+    {
+        ElementToJSON(writer, element);
+    }
+    writer.EndArray();
 
-        // Split by commas and parse integers
-        std::stringstream ss(value);
-        std::string item;
-        while (std::getline(ss, item, ','))
-        {
-            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
-            try
-            {
-                result.push_back(std::stoi(item));
-            }
-            catch (...)
-            {
-                // Skip invalid numbers
-            }
-        }
+    writer.EndObject();
+}
 
-        return result;
+void ConfigParser::ElementToJSON(JSONWriter& writer, const OverlayElement& element)
+{
+    writer.BeginObject();
+
+    writer.Key("id");
+    writer.String(element.id);
+
+    writer.Key("codes");
+    writer.BeginObject();
+    writer.Key("hid");
+    writer.Int(element.key.hid);
+    writer.Key("winvk");
+    writer.Int(element.key.winvk);
+    writer.Key("evdev");
+    writer.Int(element.key.evdev);
+    writer.EndObject();
+
+    writer.Key("pos");
+    Vector2iToJSON(writer, element.position);
+
+    // Only the states that were set, so defaults still apply when re-parsed
+    const SpriteInfo& sprite = element.sprite;
+    writer.Key("sprite");
+    writer.BeginObject();
+    writer.Key("normal");
+    IntRectToJSON(writer, sprite.normal);
+    if (sprite.hasPressedState)
+    {
+        writer.Key("pressed");
+        IntRectToJSON(writer, sprite.pressed);
     }
-
-    bool FindKeyValue(const std::string& json, const std::string& key, std::string& value)
+    if (sprite.hasUpState)
     {
-        // Find the key in quotes
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-
-        if (keyPos == std::string::npos)
-            return false;
-
-        // Find the colon after the key
-        size_t colonPos = json.find(":", keyPos);
-        if (colonPos == std::string::npos)
-            return false;
-
-        // Skip whitespace after colon
-        size_t valueStart = colonPos + 1;
-        while (valueStart < json.length() && std::isspace(json[valueStart]))
-            valueStart++;
-
-        if (valueStart >= json.length())
-            return false;
-
-        // Determine value type and extract accordingly
-        char firstChar = json[valueStart];
-        size_t valueEnd;
-
-        if (firstChar == '"')
-        {
-            // String value
-            valueEnd = json.find('"', valueStart + 1);
-            if (valueEnd == std::string::npos)
-                return false;
-            value = json.substr(valueStart, valueEnd - valueStart + 1);
-        }
-        else if (firstChar == '[')
-        {
-            // Array value
-            int bracketCount = 0;
-            valueEnd = valueStart;
-            do
-            {
-                if (json[valueEnd] == '[') bracketCount++;
-                else if (json[valueEnd] == ']') bracketCount--;
-                valueEnd++;
-            } while (valueEnd < json.length() && bracketCount > 0);
-
-            value = json.substr(valueStart, valueEnd - valueStart);
-        }
-        else if (firstChar == '{')
-        {
-            // Object value
-            int braceCount = 0;
-            valueEnd = valueStart;
-            do
-            {
-                if (json[valueEnd] == '{') braceCount++;
-                else if (json[valueEnd] == '}') braceCount--;
-                valueEnd++;
-            } while (valueEnd < json.length() && braceCount > 0);
+        writer.Key("up");
+        IntRectToJSON(writer, sprite.up);
+    }
+    if (sprite.hasDownState)
+    {
+        writer.Key("down");
+        IntRectToJSON(writer, sprite.down);
+    }
+    writer.EndObject();
 
-            value = json.substr(valueStart, valueEnd - valueStart);
-        }
-        else
-        {
-            // Number or boolean value
-            valueEnd = valueStart;
-            while (valueEnd < json.length() &&
-                   json[valueEnd] != ',' &&
-                   json[valueEnd] != '}' &&
-                   json[valueEnd] != ']' &&
-                   !std::isspace(json[valueEnd]))
-            {
-                valueEnd++;
-            }
-            value = json.substr(valueStart, valueEnd - valueStart);
-        }
+    writer.Key("z");
+    writer.Int(element.zOrder);
 
-        return true;
+    if (element.isWheel)
+    {
+        writer.Key("wheel");
+        writer.Bool(true);
     }
 
-    std::vector<std::string> SplitArray(const std::string& arrayJson)
+    if (element.cursor.enabled)
     {
-        std::vector<std::string> result;
-
-        if (arrayJson.empty())
-            return result;
-
-        size_t pos = 0;
-        int braceCount = 0;
-        size_t start = 0;
+        writer.Key("cursor");
+        writer.BeginObject();
+        writer.Key("mode");
+        writer.String(element.cursor.mode);
+        writer.Key("radius");
+        writer.Int(element.cursor.radius);
+        writer.EndObject();
+    }
 
-        while (pos < arrayJson.length())
-        {
-            char c = arrayJson[pos];
+    writer.EndObject();
+}
 
-            if (c == '{')
-            {
-                braceCount++;
-            }
-            else if (c == '}')
-            {
-                braceCount--;
-                if (braceCount == 0)
-                {
-                    // Found complete object
-                    std::string obj = arrayJson.substr(start, pos - start + 1);
-                    result.push_back(obj);
-
-                    // Find next object start
-                    pos++;
-                    while (pos < arrayJson.length() && (arrayJson[pos] == ',' || std::isspace(arrayJson[pos])))
-                        pos++;
-                    start = pos;
-                    continue;
-                }
-            }
+void ConfigParser::IntArrayToJSON(JSONWriter& writer, const std::vector<int>& arr)
+{
+    writer.IntArray(arr.data(), arr.size());
+}
 
-            pos++;
-        }
+void ConfigParser::Vector2iToJSON(JSONWriter& writer, const Vector2i& vec)
+{
+    const int values[2] = { vec.x, vec.y };
+    writer.IntArray(values, 2);
+}
 
-        return result;
-    }
+void ConfigParser::IntRectToJSON(JSONWriter& writer, const IntRect& rect)
+{
+    const int values[4] = { rect.left, rect.top, rect.width, rect.height };
+    writer.IntArray(values, 4);
 }
\ No newline at end of file
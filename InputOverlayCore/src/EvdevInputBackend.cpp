@@ -0,0 +1,317 @@
+#include "../include/EvdevInputBackend.h"
+#include "../include/KeyCodes.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace
+{
+    const char* INPUT_DEVICE_DIR = "/dev/input";
+    const uint32_t WAKE_EVENT_ID = 0xFFFFFFFF;
+    const int EVENTS_PER_READ = 64;
+
+    bool TestBit(const unsigned long* bits, int bit)
+    {
+        const int bitsPerLong = static_cast<int>(sizeof(unsigned long) * 8);
+        return (bits[bit / bitsPerLong] >> (bit % bitsPerLong)) & 1UL;
+    }
+}
+
+EvdevInputBackend::EvdevInputBackend()
+    : m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_shouldStop(false)
+{
+}
+
+EvdevInputBackend::~EvdevInputBackend()
+{
+    Shutdown();
+}
+
+bool EvdevInputBackend::Initialize()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0)
+    {
+        std::cerr << "epoll_create1 failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0)
+    {
+        std::cerr << "eventfd failed: " << strerror(errno) << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    epoll_event wakeEvent = {};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.u32 = WAKE_EVENT_ID;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wakeEvent);
+
+    if (!OpenDevices())
+    {
+        std::cerr << "No readable keyboard or mouse devices in " << INPUT_DEVICE_DIR
+                  << " (is the user in the 'input' group?)" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    m_capturedEvents.reserve(1024);
+    m_shouldStop = false;
+    m_captureThread = std::thread(&EvdevInputBackend::CaptureThreadFunc, this);
+    return true;
+}
+
+void EvdevInputBackend::Shutdown()
+{
+    m_shouldStop = true;
+
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    if (m_captureThread.joinable())
+        m_captureThread.join();
+
+    for (auto& device : m_devices)
+    {
+        CloseDevice(device);
+    }
+    m_devices.clear();
+
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+bool EvdevInputBackend::OpenDevices()
+{
+    DIR* dir = opendir(INPUT_DEVICE_DIR);
+    if (!dir)
+    {
+        std::cerr << "Failed to open " << INPUT_DEVICE_DIR << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> paths;
+    while (dirent* entry = readdir(dir))
+    {
+        if (strncmp(entry->d_name, "event", 5) == 0)
+        {
+            paths.push_back(std::string(INPUT_DEVICE_DIR) + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(paths.begin(), paths.end());
+
+    for (const auto& path : paths)
+    {
+        OpenDevice(path, static_cast<uint16_t>(m_devices.size()));
+    }
+
+    return !m_devices.empty();
+}
+
+bool EvdevInputBackend::OpenDevice(const std::string& path, uint16_t index)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    // Only keep devices that report keys/buttons or relative motion
+    unsigned long eventBits[(EV_MAX + 1 + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8)] = {};
+    unsigned long keyBits[(KEY_MAX + 1 + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8)] = {};
+    ioctl(fd, EVIOCGBIT(0, sizeof(eventBits)), eventBits);
+    ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+
+    bool isKeyboard = TestBit(eventBits, EV_KEY) && TestBit(keyBits, KEY_A);
+    bool isMouse = TestBit(eventBits, EV_REL) || (TestBit(eventBits, EV_KEY) && TestBit(keyBits, BTN_LEFT));
+    if (!isKeyboard && !isMouse)
+    {
+        close(fd);
+        return false;
+    }
+
+    // Report timestamps on the same clock as GetInputTimestampNs()
+    int clockId = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clockId);
+
+    char name[256] = {};
+    ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+
+    epoll_event deviceEvent = {};
+    deviceEvent.events = EPOLLIN;
+    deviceEvent.data.u32 = index;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &deviceEvent) < 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    Device device;
+    device.fd = fd;
+    device.index = index;
+    device.path = path;
+    device.name = name;
+    m_devices.push_back(device);
+
+    std::cout << "Opened input device " << path << " (" << name << ")" << std::endl;
+    return true;
+}
+
+void EvdevInputBackend::CloseDevice(Device& device)
+{
+    if (device.fd >= 0)
+    {
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, device.fd, nullptr);
+        close(device.fd);
+        device.fd = -1;
+    }
+}
+
+void EvdevInputBackend::CaptureThreadFunc()
+{
+    epoll_event ready[16];
+    std::vector<InputEvent> batch;
+    batch.reserve(EVENTS_PER_READ * 16);
+
+    while (!m_shouldStop)
+    {
+        int count = epoll_wait(m_epollFd, ready, 16, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        batch.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            uint32_t id = ready[i].data.u32;
+            if (id == WAKE_EVENT_ID || id >= m_devices.size())
+                continue;
+
+            Device& device = m_devices[id];
+            if (!ReadDevice(device, batch))
+            {
+                std::cout << "Input device removed: " << device.path << std::endl;
+                CloseDevice(device);
+            }
+        }
+
+        if (!batch.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_capturedMutex);
+            m_capturedEvents.insert(m_capturedEvents.end(), batch.begin(), batch.end());
+        }
+    }
+}
+
+bool EvdevInputBackend::ReadDevice(Device& device, std::vector<InputEvent>& batch)
+{
+    input_event rawEvents[EVENTS_PER_READ];
+
+    while (true)
+    {
+        ssize_t bytesRead = read(device.fd, rawEvents, sizeof(rawEvents));
+        if (bytesRead < 0)
+        {
+            // EAGAIN: drained; anything else (ENODEV) means the device is gone
+            return errno == EAGAIN || errno == EINTR;
+        }
+
+        size_t eventCount = static_cast<size_t>(bytesRead) / sizeof(input_event);
+        for (size_t i = 0; i < eventCount; ++i)
+        {
+            const input_event& raw = rawEvents[i];
+
+            InputEvent event;
+            event.timestampNs = static_cast<uint64_t>(raw.input_event_sec) * 1000000000ULL +
+                                static_cast<uint64_t>(raw.input_event_usec) * 1000ULL;
+            event.device = device.index;
+
+            if (raw.type == EV_KEY)
+            {
+                // value 2 is autorepeat, not an edge
+                if (raw.value == 2)
+                    continue;
+
+                int virtualKey = KeyCodes::EvdevToVirtualKey(raw.code);
+                if (virtualKey == 0)
+                    continue;
+
+                event.type = InputEventType::Key;
+                event.code = virtualKey;
+                event.value = raw.value != 0 ? 1 : 0;
+            }
+            else if (raw.type == EV_REL)
+            {
+                // Motion is summed, not queued; Poll() emits one event per axis
+                switch (raw.code)
+                {
+                case REL_X: m_mouse.AddMotion(event.timestampNs, raw.value, 0); break;
+                case REL_Y: m_mouse.AddMotion(event.timestampNs, 0, raw.value); break;
+                case REL_WHEEL:
+                    // One detent per unit; scale to WHEEL_DELTA like Windows reports
+                    m_mouse.AddWheel(event.timestampNs, raw.value * 120);
+                    break;
+                default:
+                    break;
+                }
+                continue;
+            }
+            else
+            {
+                continue;
+            }
+
+            batch.push_back(event);
+        }
+
+        if (static_cast<size_t>(bytesRead) < sizeof(rawEvents))
+            return true;
+    }
+}
+
+void EvdevInputBackend::Poll(std::vector<InputEvent>& events)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_capturedMutex);
+        events.insert(events.end(), m_capturedEvents.begin(), m_capturedEvents.end());
+        m_capturedEvents.clear();
+    }
+
+    MouseAccumulator::AppendEvents(m_mouse.Drain(), GetInputTimestampNs(), events);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "../include/FileWatcher.h"
+#include "../include/InputBackend.h"
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+static uint64_t GetLastWriteTime(const std::string& path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes))
+        return 0;
+
+    return (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+           attributes.ftLastWriteTime.dwLowDateTime;
+}
+
+#endif
+
+FileWatcher::FileWatcher()
+#ifndef _WIN32
+    : m_inotifyFd(-1)
+#endif
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    Shutdown();
+}
+
+bool FileWatcher::Initialize()
+{
+#if defined(_WIN32)
+    return true;
+#elif defined(__linux__)
+    if (m_inotifyFd >= 0)
+        return true;
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0)
+    {
+        std::cerr << "inotify_init1 failed: " << errno << std::endl;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::Shutdown()
+{
+    for (auto& directory : m_directories)
+    {
+        RemoveDirectoryWatch(directory);
+    }
+    m_directories.clear();
+
+#ifdef __linux__
+    if (m_inotifyFd >= 0)
+    {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+#endif
+}
+
+std::string FileWatcher::CanonicalPath(const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error)
+        canonical = std::filesystem::absolute(path, error).lexically_normal();
+    return canonical.string();
+}
+
+void FileWatcher::SplitPath(const std::string& path, std::string& directory, std::string& name)
+{
+    std::filesystem::path filePath = std::filesystem::path(path).lexically_normal();
+    name = filePath.filename().string();
+    directory = filePath.parent_path().string();
+    if (directory.empty())
+        directory = ".";
+}
+
+void FileWatcher::RemoveDirectoryWatch(WatchedDirectory& directory)
+{
+#if defined(_WIN32)
+    FindCloseChangeNotification(directory.handle);
+#elif defined(__linux__)
+    inotify_rm_watch(m_inotifyFd, directory.wd);
+#else
+    (void)directory;
+#endif
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    std::string canonicalPath = CanonicalPath(path);
+    std::string directoryPath;
+    std::string name;
+    SplitPath(canonicalPath, directoryPath, name);
+
+    auto directory = std::find_if(m_directories.begin(), m_directories.end(),
+        [&](const WatchedDirectory& d) { return d.path == directoryPath; });
+
+    if (directory == m_directories.end())
+    {
+        WatchedDirectory added;
+        added.path = directoryPath;
+
+#if defined(_WIN32)
+        added.handle = FindFirstChangeNotificationA(directoryPath.c_str(), FALSE,
+                                                    FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (added.handle == INVALID_HANDLE_VALUE)
+        {
+            std::cerr << "Failed to watch " << directoryPath << ": " << GetLastError() << std::endl;
+            return false;
+        }
+#elif defined(__linux__)
+        if (m_inotifyFd < 0)
+            return false;
+
+        added.wd = inotify_add_watch(m_inotifyFd, directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (added.wd < 0)
+        {
+            std::cerr << "Failed to watch " << directoryPath << ": " << errno << std::endl;
+            return false;
+        }
+
+        // The same directory under another path (a bind mount) gets the same
+        // watch descriptor; removing it for one would end it for both
+        directory = std::find_if(m_directories.begin(), m_directories.end(),
+            [&](const WatchedDirectory& d) { return d.wd == added.wd; });
+#else
+        return false;
+#endif
+
+        if (directory == m_directories.end())
+        {
+            m_directories.push_back(std::move(added));
+            directory = m_directories.end() - 1;
+        }
+    }
+
+    auto file = std::find_if(directory->files.begin(), directory->files.end(),
+        [&](const WatchedFile& f) { return f.path == canonicalPath; });
+
+    if (file == directory->files.end())
+    {
+        WatchedFile added;
+        added.path = canonicalPath;
+        added.name = name;
+#ifdef _WIN32
+        added.lastWrite = GetLastWriteTime(canonicalPath);
+#endif
+        directory->files.push_back(std::move(added));
+        file = directory->files.end() - 1;
+    }
+
+    ++file->refCount;
+    return true;
+}
+
+void FileWatcher::Unwatch(const std::string& path)
+{
+    std::string canonicalPath = CanonicalPath(path);
+
+    // By file rather than directory path: a shared watch is listed under the
+    // path it was first added with
+    for (auto directory = m_directories.begin(); directory != m_directories.end(); ++directory)
+    {
+        auto file = std::find_if(directory->files.begin(), directory->files.end(),
+            [&](const WatchedFile& f) { return f.path == canonicalPath; });
+        if (file == directory->files.end())
+            continue;
+
+        if (--file->refCount > 0)
+            return;
+
+        directory->files.erase(file);
+        if (directory->files.empty())
+        {
+            RemoveDirectoryWatch(*directory);
+            m_directories.erase(directory);
+        }
+        return;
+    }
+}
+
+void FileWatcher::AddChange(std::vector<FileChange>& changes, size_t firstNew, const std::string& path, uint64_t timestamp)
+{
+    // Saving often produces several events for one file
+    for (size_t i = firstNew; i < changes.size(); ++i)
+    {
+        if (changes[i].path == path)
+            return;
+    }
+
+    changes.push_back({ path, timestamp });
+}
+
+void FileWatcher::Poll(std::vector<FileChange>& changes)
+{
+    size_t firstNew = changes.size();
+
+#if defined(_WIN32)
+    for (auto& directory : m_directories)
+    {
+        if (WaitForSingleObject(directory.handle, 0) != WAIT_OBJECT_0)
+            continue;
+
+        // Re-arm first so a write during the scan signals again
+        FindNextChangeNotification(directory.handle);
+
+        uint64_t timestamp = GetInputTimestampNs();
+        for (auto& file : directory.files)
+        {
+            uint64_t lastWrite = GetLastWriteTime(file.path);
+            if (lastWrite != 0 && lastWrite != file.lastWrite)
+            {
+                file.lastWrite = lastWrite;
+                AddChange(changes, firstNew, file.path, timestamp);
+            }
+        }
+    }
+#elif defined(__linux__)
+    if (m_inotifyFd < 0)
+        return;
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        uint64_t timestamp = GetInputTimestampNs();
+        for (char* cursor = buffer; cursor < buffer + length; )
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+
+            if (event->len == 0)
+                continue;
+
+            for (const auto& directory : m_directories)
+            {
+                if (directory.wd != event->wd)
+                    continue;
+
+                for (const auto& file : directory.files)
+                {
+                    if (file.name == event->name)
+                        AddChange(changes, firstNew, file.path, timestamp);
+                }
+            }
+        }
+    }
+#else
+    (void)firstNew;
+#endif
+}
\ No newline at end of file
@@ -1,12 +1,22 @@
 #include "../include/IPCManager.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+
+namespace
+{
+    // Sent payloads kept for reuse; only small ones, so a large config that
+    // went out once does not stay allocated
+    const size_t MAX_SPARE_BUFFERS = 8;
+    const size_t MAX_SPARE_CAPACITY = 4096;
+}
 
 IPCManager::IPCManager()
-    : m_hPipe(INVALID_HANDLE_VALUE)
-    , m_isConnected(false)
+    : m_isConnected(false)
     , m_shouldStop(false)
 {
+    m_spareBuffers.reserve(MAX_SPARE_BUFFERS);
 }
 
 IPCManager::~IPCManager()
@@ -14,33 +24,45 @@ IPCManager::~IPCManager()
     Shutdown();
 }
 
-bool IPCManager::Initialize()
+bool IPCManager::Initialize(std::unique_ptr<IPCTransport> transport)
 {
-    if (!CreateNamedPipe())
+    m_transport = transport ? std::move(transport) : CreateDefaultIPCTransport();
+    if (!m_transport || !m_transport->Initialize())
     {
-        std::cerr << "Failed to create named pipe!" << std::endl;
+        std::cerr << "Failed to create IPC transport!" << std::endl;
+        m_transport.reset();
         return false;
     }
 
+    m_shouldStop = false;
+
     // Start worker threads
     m_readerThread = std::thread(&IPCManager::ReaderThreadFunc, this);
     m_writerThread = std::thread(&IPCManager::WriterThreadFunc, this);
 
-    std::cout << "IPC Manager initialized. Waiting for UI connection..." << std::endl;
+    std::cout << "IPC Manager initialized (" << m_transport->GetName() << "). Waiting for UI connection..." << std::endl;
     return true;
 }
 
 void IPCManager::Shutdown()
 {
-    m_shouldStop = true;
+    {
+        std::lock_guard<std::mutex> lock(m_outgoingMutex);
+        m_shouldStop = true;
+    }
+    m_outgoingReady.notify_all();
 
-    DisconnectPipe();
+    if (m_transport)
+        m_transport->Shutdown();
 
     if (m_readerThread.joinable())
         m_readerThread.join();
 
     if (m_writerThread.joinable())
         m_writerThread.join();
+
+    m_transport.reset();
+    m_isConnected = false;
 }
 
 void IPCManager::Cleanup()
@@ -48,69 +70,59 @@ void IPCManager::Cleanup()
     Shutdown();
 }
 
-bool IPCManager::CreateNamedPipe()
+bool IPCManager::SendMessage(const IPCMessage& message)
 {
-    // First, try to clean up any existing pipe with the same name
-    HANDLE testPipe = CreateFileA(
-        PIPE_NAME.c_str(),
-        GENERIC_READ | GENERIC_WRITE,
-        0,
-        NULL,
-        OPEN_EXISTING,
-        0,
-        NULL
-    );
-
-    if (testPipe != INVALID_HANDLE_VALUE)
-    {
-        CloseHandle(testPipe);
-        std::cout << "Warning: Pipe already exists, attempting to create anyway..." << std::endl;
-    }
+    return SendMessage(IPCMessage(message));
+}
 
-    m_hPipe = CreateNamedPipeA(
-        PIPE_NAME.c_str(),
-        PIPE_ACCESS_DUPLEX,
-        PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
-        PIPE_UNLIMITED_INSTANCES, // Allow multiple instances to prevent conflicts
-        MAX_MESSAGE_SIZE,
-        MAX_MESSAGE_SIZE,
-        0, // Default timeout
-        NULL // Default security
-    );
-
-    if (m_hPipe == INVALID_HANDLE_VALUE)
+bool IPCManager::SendMessage(IPCMessage&& message)
+{
+    if (message.data.size() > IPCProtocol::MAX_MESSAGE_PAYLOAD)
     {
-        DWORD error = GetLastError();
-        std::cerr << "CreateNamedPipe failed: " << error << std::endl;
-
-        if (error == ERROR_ALREADY_EXISTS || error == ERROR_PIPE_BUSY)
-        {
-            std::cerr << "Pipe is already in use. Please ensure no other instances are running." << std::endl;
-            std::cerr << "You may need to run: taskkill //f //im InputOverlayCore.exe" << std::endl;
-        }
-
+        std::cerr << "IPC message too large to send: " << message.data.size() << " bytes" << std::endl;
         return false;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_outgoingMutex);
+        m_outgoingMessages.push_back(std::move(message));
+    }
+    m_outgoingReady.notify_one();
     return true;
 }
 
-void IPCManager::DisconnectPipe()
+void IPCManager::SendReply(const IPCMessage& request, bool succeeded)
 {
-    if (m_hPipe != INVALID_HANDLE_VALUE)
-    {
-        DisconnectNamedPipe(m_hPipe);
-        CloseHandle(m_hPipe);
-        m_hPipe = INVALID_HANDLE_VALUE;
-    }
-    m_isConnected = false;
+    if (request.correlationId == 0)
+        return;
+
+    IPCMessage reply;
+    reply.type = IPCMessageType::STATUS_UPDATE;
+    reply.overlayId = request.overlayId;
+    reply.correlationId = request.correlationId;
+    reply.data = succeeded ? "ok" : "error";
+    SendMessage(std::move(reply));
 }
 
-bool IPCManager::SendMessage(const IPCMessage& message)
+std::string IPCManager::TakePayloadBuffer()
 {
     std::lock_guard<std::mutex> lock(m_outgoingMutex);
-    m_outgoingMessages.push(message);
-    return true;
+    if (m_spareBuffers.empty())
+        return std::string();
+
+    std::string buffer = std::move(m_spareBuffers.back());
+    m_spareBuffers.pop_back();
+    buffer.clear();
+    return buffer;
+}
+
+void IPCManager::SetConnected(bool connected)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_outgoingMutex);
+        m_isConnected = connected;
+    }
+    m_outgoingReady.notify_one();
 }
 
 bool IPCManager::ReceiveMessage(IPCMessage& message)
@@ -119,223 +131,222 @@ bool IPCManager::ReceiveMessage(IPCMessage& message)
     if (m_incomingMessages.empty())
         return false;
 
-    message = m_incomingMessages.front();
+    message = std::move(m_incomingMessages.front());
     m_incomingMessages.pop();
     return true;
 }
 
+bool IPCManager::WaitForMessage(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(m_incomingMutex);
+    return m_incomingReady.wait_until(lock, deadline, [this]() { return !m_incomingMessages.empty(); });
+}
+
 void IPCManager::ReaderThreadFunc()
 {
-    char buffer[MAX_MESSAGE_SIZE];
+    // Both reused: messageData holds one frame at a time, so it stays small
+    // however large the messages being assembled are
+    std::string messageData;
+    IPCProtocol::MessageAssembler assembler;
+    IPCMessage message;
 
     while (!m_shouldStop)
     {
         if (!m_isConnected)
         {
             // Wait for client connection
-            if (ConnectNamedPipe(m_hPipe, NULL) || GetLastError() == ERROR_PIPE_CONNECTED)
-            {
-                m_isConnected = true;
-                std::cout << "UI connected to IPC pipe." << std::endl;
-            }
-            else
-            {
-                Sleep(100);
+            if (!m_transport->WaitForClient())
                 continue;
-            }
-        }
 
-        DWORD bytesRead = 0;
-        BOOL success = ReadFile(m_hPipe, buffer, MAX_MESSAGE_SIZE, &bytesRead, NULL);
+            SetConnected(true);
+            std::cout << "UI connected to IPC " << m_transport->GetName() << "." << std::endl;
+        }
 
-        if (!success || bytesRead == 0)
+        if (!m_transport->Read(messageData))
         {
-            DWORD error = GetLastError();
-            if (error == ERROR_BROKEN_PIPE)
+            assembler.Reset();
+            if (!m_shouldStop)
             {
-                std::cout << "UI disconnected from IPC pipe." << std::endl;
-                DisconnectNamedPipe(m_hPipe);
-                m_isConnected = false;
-                continue;
-            }
-            else
-            {
-                std::cerr << "ReadFile failed: " << error << std::endl;
-                Sleep(100);
-                continue;
+                std::cout << "UI disconnected from IPC " << m_transport->GetName() << "." << std::endl;
+                m_transport->Disconnect();
+                SetConnected(false);
             }
+            continue;
         }
 
-        // Parse received message
-        std::string messageData(buffer, bytesRead);
-        IPCMessage message;
-        if (DeserializeMessage(messageData, message))
+        switch (assembler.Feed(messageData, message))
+        {
+        case IPCProtocol::MessageAssembler::Result::Incomplete:
+            break;
+        case IPCProtocol::MessageAssembler::Result::Complete:
         {
-            std::lock_guard<std::mutex> lock(m_incomingMutex);
-            m_incomingMessages.push(message);
+            {
+                std::lock_guard<std::mutex> lock(m_incomingMutex);
+                m_incomingMessages.push(std::move(message));
+            }
+            m_incomingReady.notify_one();
+            break;
+        }
+        case IPCProtocol::MessageAssembler::Result::Malformed:
+            std::cerr << "Dropped a malformed IPC frame (" << messageData.size() << " bytes)" << std::endl;
+            break;
         }
     }
 }
 
 void IPCManager::WriterThreadFunc()
 {
-    while (!m_shouldStop)
+    std::vector<IPCMessage> pending;
+    std::string frame; // Reused, so encoding does not allocate once it has grown
+
+    for (;;)
     {
-        if (!m_isConnected)
+        // Messages queued while disconnected wait for the next client
         {
-            Sleep(100);
-            continue;
-        }
+            std::unique_lock<std::mutex> lock(m_outgoingMutex);
+            m_outgoingReady.wait(lock, [this]()
+            {
+                return m_shouldStop || (m_isConnected && !m_outgoingMessages.empty());
+            });
+
+            if (m_shouldStop)
+                break;
 
-        IPCMessage message;
-        bool hasMessage = false;
+            // Take everything queued so far in one go
+            std::swap(pending, m_outgoingMessages);
+        }
 
+        size_t sent = 0;
+        for (; sent < pending.size(); ++sent)
         {
-            std::lock_guard<std::mutex> lock(m_outgoingMutex);
-            if (!m_outgoingMessages.empty())
+            // An empty payload still takes one frame
+            const IPCMessage& message = pending[sent];
+            size_t offset = 0;
+            bool written;
+            do
             {
-                message = m_outgoingMessages.front();
-                m_outgoingMessages.pop();
-                hasMessage = true;
-            }
+                frame.clear();
+                offset += IPCProtocol::EncodeFrame(message, offset, frame);
+                written = m_transport->Write(frame);
+            } while (written && offset < message.data.size());
+
+            if (!written)
+                break;
         }
 
-        if (!hasMessage)
+        bool failed = sent < pending.size();
+        if (failed && !m_shouldStop)
         {
-            Sleep(10);
-            continue;
+            std::cout << "UI disconnected during write." << std::endl;
+            m_transport->Disconnect();
+            SetConnected(false);
         }
 
-        std::string messageData = SerializeMessage(message);
-        DWORD bytesWritten = 0;
-
-        BOOL success = WriteFile(
-            m_hPipe,
-            messageData.c_str(),
-            static_cast<DWORD>(messageData.length()),
-            &bytesWritten,
-            NULL
-        );
-
-        if (!success)
+        std::lock_guard<std::mutex> lock(m_outgoingMutex);
+        for (size_t i = 0; i < sent && m_spareBuffers.size() < MAX_SPARE_BUFFERS; ++i)
         {
-            DWORD error = GetLastError();
-            if (error == ERROR_BROKEN_PIPE)
-            {
-                std::cout << "UI disconnected during write." << std::endl;
-                DisconnectNamedPipe(m_hPipe);
-                m_isConnected = false;
-            }
-            else
-            {
-                std::cerr << "WriteFile failed: " << error << std::endl;
-            }
+            std::string& payload = pending[i].data;
+            // Short strings keep their characters inline; nothing to reuse there
+            if (payload.capacity() > std::string().capacity() && payload.capacity() <= MAX_SPARE_CAPACITY)
+                m_spareBuffers.push_back(std::move(payload));
         }
-    }
-}
-
-std::string IPCManager::SerializeMessage(const IPCMessage& message)
-{
-    std::ostringstream oss;
-    oss << static_cast<int>(message.type) << "|"
-        << message.overlayId << "|"
-        << (message.noBorders ? 1 : 0) << "|"
-        << (message.topMost ? 1 : 0) << "|"
-        << message.data.length() << "|"
-        << message.data;
-    return oss.str();
-}
 
-bool IPCManager::DeserializeMessage(const std::string& data, IPCMessage& message)
-{
-    std::istringstream iss(data);
-    std::string token;
-
-    try
-    {
-        // Parse type
-        if (!std::getline(iss, token, '|')) return false;
-        message.type = static_cast<IPCMessageType>(std::stoi(token));
-
-        // Parse overlay ID
-        if (!std::getline(iss, token, '|')) return false;
-        message.overlayId = std::stoi(token);
-
-        // Parse noBorders
-        if (!std::getline(iss, token, '|')) return false;
-        message.noBorders = (std::stoi(token) != 0);
-
-        // Parse topMost
-        if (!std::getline(iss, token, '|')) return false;
-        message.topMost = (std::stoi(token) != 0);
-
-        // Parse data length
-        if (!std::getline(iss, token, '|')) return false;
-        size_t dataLength = std::stoul(token);
-
-        // Parse data
-        std::string remainingData;
-        std::getline(iss, remainingData);
-        if (remainingData.length() != dataLength)
+        if (!failed)
         {
-            std::cerr << "Data length mismatch in IPC message" << std::endl;
-            return false;
+            pending.clear();
+            continue;
         }
 
-        message.data = remainingData;
-        return true;
-    }
-    catch (const std::exception& e)
-    {
-        std::cerr << "IPC message deserialization error: " << e.what() << std::endl;
-        return false;
+        // The failed message is dropped; the rest go out ahead of newer ones once
+        // the reader has picked up a new client
+        pending.erase(pending.begin(), pending.begin() + sent + 1);
+        pending.insert(pending.end(), std::make_move_iterator(m_outgoingMessages.begin()),
+                       std::make_move_iterator(m_outgoingMessages.end()));
+        m_outgoingMessages.clear();
+        std::swap(pending, m_outgoingMessages);
     }
 }
 
-// Protocol implementation
 namespace IPCProtocol
 {
-    std::string EncodeMessage(const IPCMessage& message)
+    size_t EncodeFrame(const IPCMessage& message, size_t offset, std::string& out)
     {
-        MessageHeader header;
-        header.type = static_cast<uint32_t>(message.type);
-        header.overlayId = static_cast<uint32_t>(message.overlayId);
-        header.dataSize = static_cast<uint32_t>(message.data.length());
-
-        std::string encoded;
-        encoded.resize(HEADER_SIZE + header.dataSize);
+        size_t length = std::min<size_t>(message.data.size() - offset, MAX_FRAME_PAYLOAD);
+
+        FrameHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.type = static_cast<uint8_t>(message.type);
+        header.flags = (message.noBorders ? FLAG_NO_BORDERS : 0) | (message.topMost ? FLAG_TOP_MOST : 0);
+        header.headerSize = sizeof(FrameHeader);
+        header.correlationId = message.correlationId;
+        header.overlayId = message.overlayId;
+        header.messageSize = static_cast<uint32_t>(message.data.size());
+        header.payloadOffset = static_cast<uint32_t>(offset);
+        header.payloadSize = static_cast<uint32_t>(length);
+
+        size_t start = out.size();
+        out.resize(start + sizeof(FrameHeader) + length);
+        std::memcpy(&out[start], &header, sizeof(FrameHeader));
+        if (length > 0)
+            std::memcpy(&out[start + sizeof(FrameHeader)], message.data.data() + offset, length);
+        return length;
+    }
 
-        // Copy header
-        memcpy(&encoded[0], &header, HEADER_SIZE);
+    bool ParseFrame(std::string_view frame, FrameView& view)
+    {
+        if (frame.size() < sizeof(FrameHeader))
+            return false;
 
-        // Copy data
-        if (header.dataSize > 0)
+        std::memcpy(&view.header, frame.data(), sizeof(FrameHeader));
+        const FrameHeader& header = view.header;
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.headerSize < sizeof(FrameHeader) || header.headerSize > frame.size() ||
+            header.payloadSize != frame.size() - header.headerSize ||
+            static_cast<uint64_t>(header.payloadOffset) + header.payloadSize > header.messageSize)
         {
-            memcpy(&encoded[HEADER_SIZE], message.data.c_str(), header.dataSize);
+            return false;
         }
 
-        return encoded;
+        view.payload = frame.substr(header.headerSize);
+        return true;
     }
 
-    bool DecodeMessage(const std::string& buffer, IPCMessage& message)
+    MessageAssembler::Result MessageAssembler::Feed(std::string_view frame, IPCMessage& message)
     {
-        if (buffer.length() < HEADER_SIZE)
-            return false;
-
-        MessageHeader header;
-        memcpy(&header, buffer.c_str(), HEADER_SIZE);
-
-        message.type = static_cast<IPCMessageType>(header.type);
-        message.overlayId = static_cast<int>(header.overlayId);
-
-        if (header.dataSize > 0)
+        FrameView view;
+        if (!ParseFrame(frame, view))
         {
-            if (buffer.length() < HEADER_SIZE + header.dataSize)
-                return false;
+            m_inProgress = false;
+            return Result::Malformed;
+        }
 
-            message.data = buffer.substr(HEADER_SIZE, header.dataSize);
+        const FrameHeader& header = view.header;
+        if (!m_inProgress)
+        {
+            // Continuation frames of a message that was already dropped end up here too
+            if (header.payloadOffset != 0 || header.messageSize > MAX_MESSAGE_PAYLOAD)
+                return Result::Malformed;
+
+            m_first = header;
+            message.type = static_cast<IPCMessageType>(header.type);
+            message.overlayId = header.overlayId;
+            message.correlationId = header.correlationId;
+            message.noBorders = (header.flags & FLAG_NO_BORDERS) != 0;
+            message.topMost = (header.flags & FLAG_TOP_MOST) != 0;
+            message.data.clear();
+            message.data.reserve(header.messageSize);
+        }
+        else if (header.type != m_first.type || header.flags != m_first.flags ||
+                 header.correlationId != m_first.correlationId || header.overlayId != m_first.overlayId ||
+                 header.messageSize != m_first.messageSize || header.payloadOffset != message.data.size())
+        {
+            m_inProgress = false;
+            return Result::Malformed;
         }
 
-        return true;
+        message.data.append(view.payload.data(), view.payload.size());
+        m_inProgress = message.data.size() < header.messageSize;
+        return m_inProgress ? Result::Incomplete : Result::Complete;
     }
 }
\ No newline at end of file
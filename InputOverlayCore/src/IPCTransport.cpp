@@ -0,0 +1,14 @@
+#include "../include/IPCTransport.h"
+#include "../include/NamedPipeTransport.h"
+#include "../include/UnixSocketTransport.h"
+
+std::unique_ptr<IPCTransport> CreateDefaultIPCTransport()
+{
+#if defined(_WIN32)
+    return std::make_unique<NamedPipeTransport>();
+#elif defined(__linux__)
+    return std::make_unique<UnixSocketTransport>();
+#else
+    return nullptr;
+#endif
+}
\ No newline at end of file
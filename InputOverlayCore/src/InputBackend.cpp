@@ -0,0 +1,41 @@
+#include "../include/InputBackend.h"
+#include "../include/Win32InputBackend.h"
+#include "../include/EvdevInputBackend.h"
+
+#ifndef _WIN32
+#include <ctime>
+#endif
+
+uint64_t GetInputTimestampNs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = []() {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f;
+    }();
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Split to avoid overflowing 64 bits on long uptimes
+    uint64_t ticks = static_cast<uint64_t>(counter.QuadPart);
+    uint64_t freq = static_cast<uint64_t>(frequency.QuadPart);
+    return (ticks / freq) * 1000000000ULL + (ticks % freq) * 1000000000ULL / freq;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+std::unique_ptr<InputBackend> CreateDefaultInputBackend()
+{
+#if defined(_WIN32)
+    return std::make_unique<Win32InputBackend>();
+#elif defined(__linux__)
+    return std::make_unique<EvdevInputBackend>();
+#else
+    return nullptr;
+#endif
+}
\ No newline at end of file
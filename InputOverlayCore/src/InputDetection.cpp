@@ -1,17 +1,18 @@
 #include "../include/InputDetection.h"
+#include "../include/KeyCodes.h"
+#include "../include/InputRecording.h"
 #include <iostream>
+#include <algorithm>
 
 InputDetection::InputDetection()
-    : m_pDirectInput(nullptr)
-    , m_pMouseDevice(nullptr)
-    , m_hInstance(nullptr)
 {
-    ZeroMemory(&m_mouseState, sizeof(m_mouseState));
     m_mousePosition = Vector2i(0, 0);
-    m_previousMousePosition = Vector2i(0, 0);
     m_mouseMovement = Vector2i(0, 0);
     m_mouseWheelDelta = 0;
-    m_previousWheelDelta = 0;
+    m_hasAbsolutePosition = false;
+    m_mouseSampleCount = 0;
+    m_frameTimeNs = 0;
+    std::fill(std::begin(m_lastDownNs), std::end(m_lastDownNs), 0);
 }
 
 InputDetection::~InputDetection()
@@ -21,229 +22,240 @@ InputDetection::~InputDetection()
 
 bool InputDetection::Initialize()
 {
-    m_hInstance = GetModuleHandle(nullptr);
+    return Initialize(CreateDefaultInputBackend());
+}
 
-    if (!InitializeDirectInput())
+bool InputDetection::Initialize(std::unique_ptr<InputBackend> backend)
+{
+    if (!backend)
     {
-        std::cerr << "Failed to initialize DirectInput!" << std::endl;
+        std::cerr << "No input backend available on this platform!" << std::endl;
         return false;
     }
 
-    if (!InitializeMouse())
+    if (!backend->Initialize())
     {
-        std::cerr << "Failed to initialize mouse input!" << std::endl;
+        std::cerr << "Failed to initialize " << backend->GetName() << " input backend!" << std::endl;
         return false;
     }
 
-    std::cout << "Input detection initialized successfully." << std::endl;
+    m_backend = std::move(backend);
+    m_pendingEvents.reserve(1024);
+
+    std::cout << "Input detection initialized successfully (" << m_backend->GetName() << " backend)." << std::endl;
     return true;
 }
 
 void InputDetection::Shutdown()
 {
-    if (m_pMouseDevice)
-    {
-        m_pMouseDevice->Unacquire();
-        m_pMouseDevice->Release();
-        m_pMouseDevice = nullptr;
-    }
+    StopRecording();
 
-    if (m_pDirectInput)
+    if (m_backend)
     {
-        m_pDirectInput->Release();
-        m_pDirectInput = nullptr;
+        m_backend->Shutdown();
+        m_backend.reset();
     }
 }
 
-bool InputDetection::InitializeDirectInput()
+void InputDetection::Update()
 {
-    HRESULT hr = DirectInput8Create(
-        m_hInstance,
-        DIRECTINPUT_VERSION,
-        IID_IDirectInput8,
-        (void**)&m_pDirectInput,
-        nullptr
-    );
-
-    if (FAILED(hr))
-    {
-        std::cerr << "DirectInput8Create failed: " << std::hex << hr << std::endl;
-        return false;
-    }
+    // Store previous states
+    m_previousKeyStates = m_keyStates;
+    m_latchedKeys.Clear();
 
-    return true;
-}
+    // Movement and wheel are per-update sums of the captured deltas
+    m_mouseMovement = Vector2i(0, 0);
+    m_mouseWheelDelta = 0;
+    m_mouseSampleCount = 0;
 
-bool InputDetection::InitializeMouse()
-{
-    if (!m_pDirectInput)
-        return false;
+    if (!m_backend)
+        return;
 
-    // Create mouse device
-    HRESULT hr = m_pDirectInput->CreateDevice(GUID_SysMouse, &m_pMouseDevice, nullptr);
-    if (FAILED(hr))
-    {
-        std::cerr << "Failed to create mouse device: " << std::hex << hr << std::endl;
-        return false;
-    }
+    m_pendingEvents.clear();
+    m_backend->Poll(m_pendingEvents);
+    m_frameTimeNs = m_backend->GetTimeNs(); // Not earlier than any polled event
 
-    // Set data format
-    hr = m_pMouseDevice->SetDataFormat(&c_dfDIMouse);
-    if (FAILED(hr))
-    {
-        std::cerr << "Failed to set mouse data format: " << std::hex << hr << std::endl;
-        return false;
-    }
+    if (m_recorder)
+        m_recorder->Record(m_pendingEvents);
 
-    // Set cooperative level
-    HWND hwnd = GetConsoleWindow(); // Use console window, or could be nullptr for background
-    hr = m_pMouseDevice->SetCooperativeLevel(hwnd, DISCL_BACKGROUND | DISCL_NONEXCLUSIVE);
-    if (FAILED(hr))
+    for (const auto& event : m_pendingEvents)
     {
-        std::cerr << "Failed to set mouse cooperative level: " << std::hex << hr << std::endl;
-        return false;
+        ApplyEvent(event);
     }
+}
 
-    // Acquire the device
-    hr = m_pMouseDevice->Acquire();
-    if (FAILED(hr))
-    {
-        std::cerr << "Failed to acquire mouse device: " << std::hex << hr << std::endl;
+bool InputDetection::StartRecording(const std::string& filePath)
+{
+    auto recorder = std::make_unique<InputRecorder>();
+    if (!recorder->Open(filePath))
         return false;
-    }
 
+    m_recorder = std::move(recorder);
     return true;
 }
 
-void InputDetection::Update()
+void InputDetection::StopRecording()
 {
-    // Store previous states
-    m_previousKeyStates = m_keyStates;
-
-    // Update keyboard input
-    UpdateKeyboardInput();
-
-    // Update mouse input
-    UpdateMouseInput();
+    if (m_recorder)
+    {
+        m_recorder->Close();
+        m_recorder.reset();
+    }
 }
 
-void InputDetection::UpdateKeyboardInput()
+void InputDetection::ApplyEvent(const InputEvent& event)
 {
-    // Update all keys we might care about
-    // Using GetKeyState for synchronous state checking (like Bongo Cat)
-
-    // Letters A-Z
-    for (int i = 'A'; i <= 'Z'; ++i)
+    switch (event.type)
     {
-        m_keyStates[i] = (GetKeyState(i) & 0x8000) != 0;
-    }
-
-    // Numbers 0-9
-    for (int i = '0'; i <= '9'; ++i)
+    case InputEventType::Key:
     {
-        m_keyStates[i] = (GetKeyState(i) & 0x8000) != 0;
-    }
+        if (event.code <= 0 || event.code >= KeyStateSet::KEY_COUNT)
+            break;
 
-    // Special keys
-    m_keyStates[VK_SPACE] = (GetKeyState(VK_SPACE) & 0x8000) != 0;
-    m_keyStates[VK_RETURN] = (GetKeyState(VK_RETURN) & 0x8000) != 0;
-    m_keyStates[VK_ESCAPE] = (GetKeyState(VK_ESCAPE) & 0x8000) != 0;
-    m_keyStates[VK_TAB] = (GetKeyState(VK_TAB) & 0x8000) != 0;
-    m_keyStates[VK_BACK] = (GetKeyState(VK_BACK) & 0x8000) != 0;
-    m_keyStates[VK_SHIFT] = (GetKeyState(VK_SHIFT) & 0x8000) != 0;
-    m_keyStates[VK_CONTROL] = (GetKeyState(VK_CONTROL) & 0x8000) != 0;
-    m_keyStates[VK_MENU] = (GetKeyState(VK_MENU) & 0x8000) != 0;
-
-    // Arrow keys
-    m_keyStates[VK_LEFT] = (GetKeyState(VK_LEFT) & 0x8000) != 0;
-    m_keyStates[VK_RIGHT] = (GetKeyState(VK_RIGHT) & 0x8000) != 0;
-    m_keyStates[VK_UP] = (GetKeyState(VK_UP) & 0x8000) != 0;
-    m_keyStates[VK_DOWN] = (GetKeyState(VK_DOWN) & 0x8000) != 0;
-
-    // Function keys
-    for (int i = VK_F1; i <= VK_F12; ++i)
-    {
-        m_keyStates[i] = (GetKeyState(i) & 0x8000) != 0;
-    }
-}
+        bool down = event.value != 0;
+        m_keyStates.Set(event.code, down);
+        m_journal.Append(event.timestampNs, event.code, down, event.device);
 
-void InputDetection::UpdateMouseInput()
-{
-    if (!m_pMouseDevice)
-        return;
+        if (down)
+        {
+            m_latchedKeys.Set(event.code, true);
+            m_lastDownNs[event.code] = event.timestampNs;
+        }
 
-    HRESULT hr = m_pMouseDevice->GetDeviceState(sizeof(DIMOUSESTATE), &m_mouseState);
+        // Keep the generic modifier pressed while either side is held.
+        // Sided modifiers come in pairs: VK_LSHIFT/VK_RSHIFT, VK_LCONTROL/VK_RCONTROL, ...
+        int generic = KeyCodes::GenericModifier(event.code);
+        if (generic != 0)
+        {
+            int left = event.code & ~1;
+            m_keyStates.Set(generic, m_keyStates.Test(left) || m_keyStates.Test(left + 1));
+            if (down)
+            {
+                m_latchedKeys.Set(generic, true);
+                m_lastDownNs[generic] = event.timestampNs;
+            }
+        }
 
-    if (FAILED(hr))
-    {
-        // Try to reacquire if lost
-        if (hr == DIERR_INPUTLOST || hr == DIERR_NOTACQUIRED)
+        if (event.code == VK_LBUTTON || event.code == VK_RBUTTON || event.code == VK_MBUTTON ||
+            event.code == VK_XBUTTON1 || event.code == VK_XBUTTON2)
         {
-            m_pMouseDevice->Acquire();
+            AddMouseSample(event.timestampNs, Vector2i(0, 0), 0);
         }
-        return;
+        break;
     }
 
-    // Store previous mouse position and wheel state
-    m_previousMousePosition = m_mousePosition;
-    m_previousWheelDelta = m_mouseWheelDelta;
+    case InputEventType::Relative:
+        if (event.code == INPUT_AXIS_X)
+        {
+            m_mouseMovement.x += event.value;
+            if (!m_hasAbsolutePosition)
+                m_mousePosition.x += event.value;
+        }
+        else if (event.code == INPUT_AXIS_Y)
+        {
+            m_mouseMovement.y += event.value;
+            if (!m_hasAbsolutePosition)
+                m_mousePosition.y += event.value;
+        }
+        else if (event.code == INPUT_AXIS_WHEEL)
+        {
+            m_mouseWheelDelta += event.value;
+        }
+        else
+        {
+            break;
+        }
 
-    // Update mouse position (get absolute position)
-    POINT cursorPos;
-    if (GetCursorPos(&cursorPos))
+        AddMouseSample(event.timestampNs,
+                       Vector2i(event.code == INPUT_AXIS_X ? event.value : 0, event.code == INPUT_AXIS_Y ? event.value : 0),
+                       event.code == INPUT_AXIS_WHEEL ? event.value : 0);
+        break;
+
+    case InputEventType::Absolute:
     {
-        m_mousePosition.x = cursorPos.x;
-        m_mousePosition.y = cursorPos.y;
+        // Backends may report the cursor every frame; only a move is a sample
+        m_hasAbsolutePosition = true;
+        Vector2i previous = m_mousePosition;
+        if (event.code == INPUT_AXIS_X)
+            m_mousePosition.x = event.value;
+        else if (event.code == INPUT_AXIS_Y)
+            m_mousePosition.y = event.value;
+
+        if (m_mousePosition != previous)
+            AddMouseSample(event.timestampNs, Vector2i(0, 0), 0);
+        break;
+    }
     }
+}
 
-    // Calculate mouse movement
-    m_mouseMovement.x = m_mousePosition.x - m_previousMousePosition.x;
-    m_mouseMovement.y = m_mousePosition.y - m_previousMousePosition.y;
-
-    // Update mouse wheel delta from DirectInput
-    m_mouseWheelDelta = m_mouseState.lZ;
-
-    // Update mouse button states (using DirectInput for precise timing)
-    // Note: Could also use GetKeyState(VK_LBUTTON) etc. for consistency
-    m_keyStates[VK_LBUTTON] = (m_mouseState.rgbButtons[0] & 0x80) != 0;
-    m_keyStates[VK_RBUTTON] = (m_mouseState.rgbButtons[1] & 0x80) != 0;
-    m_keyStates[VK_MBUTTON] = (m_mouseState.rgbButtons[2] & 0x80) != 0;
-
-    // Support for additional mouse buttons (X buttons)
-    if (m_mouseState.rgbButtons[3] & 0x80) // X Button 1
-        m_keyStates[VK_XBUTTON1] = true;
-    else
-        m_keyStates[VK_XBUTTON1] = false;
-
-    if (m_mouseState.rgbButtons[4] & 0x80) // X Button 2
-        m_keyStates[VK_XBUTTON2] = true;
-    else
-        m_keyStates[VK_XBUTTON2] = false;
+void InputDetection::AddMouseSample(uint64_t timestampNs, Vector2i movement, int wheelDelta)
+{
+    uint8_t buttons =
+        (m_keyStates.Test(VK_LBUTTON) ? MOUSE_BUTTON_LEFT : 0) |
+        (m_keyStates.Test(VK_RBUTTON) ? MOUSE_BUTTON_RIGHT : 0) |
+        (m_keyStates.Test(VK_MBUTTON) ? MOUSE_BUTTON_MIDDLE : 0) |
+        (m_keyStates.Test(VK_XBUTTON1) ? MOUSE_BUTTON_X1 : 0) |
+        (m_keyStates.Test(VK_XBUTTON2) ? MOUSE_BUTTON_X2 : 0);
+
+    // The axes of one report share a timestamp and become one sample; past
+    // MAX_SAMPLES everything folds into the last one, keeping the sums exact
+    if (m_mouseSampleCount > 0)
+    {
+        MouseSample& last = m_mouseSamples[m_mouseSampleCount - 1];
+        if ((last.timestampNs == timestampNs && last.buttons == buttons) ||
+            m_mouseSampleCount == MouseEventCodec::MAX_SAMPLES)
+        {
+            last.timestampNs = timestampNs;
+            last.position = m_mousePosition;
+            last.movement.x += movement.x;
+            last.movement.y += movement.y;
+            last.wheelDelta += wheelDelta;
+            last.buttons = buttons;
+            return;
+        }
+    }
+
+    MouseSample& sample = m_mouseSamples[m_mouseSampleCount++];
+    sample.timestampNs = timestampNs;
+    sample.position = m_mousePosition;
+    sample.movement = movement;
+    sample.wheelDelta = wheelDelta;
+    sample.buttons = buttons;
 }
 
 bool InputDetection::IsKeyPressed(const InputKey& key)
 {
-    int virtualKey = 0;
+    // Bindings from a parsed config are already resolved
+    int virtualKey = key.stateIndex != 0 ? key.stateIndex : KeyCodes::ResolveInputKey(key);
+    return m_keyStates.Test(virtualKey);
+}
 
-    // Priority: WinVK > HID > Evdev
-    if (key.winvk != 0)
-    {
-        virtualKey = key.winvk;
-    }
-    else if (key.hid != 0)
+void InputDetection::UpdateElementStates(OverlayConfig& config) const
+{
+    // Index 0 is never set, so unbound elements read as released without a branch
+    size_t count = std::min(config.elements.size(), config.keyStateIndices.size());
+    const uint8_t* indices = config.keyStateIndices.data();
+
+    // Taps shorter than a frame are only visible through the latch
+    KeyStateSet visible = config.latchTaps ? KeyStateSet::Union(m_keyStates, m_latchedKeys) : m_keyStates;
+
+    if (config.minPressDurationMs <= 0)
     {
-        virtualKey = ConvertHIDToVirtualKey(key.hid);
+        for (size_t i = 0; i < count; ++i)
+        {
+            config.elements[i].isPressed = visible.Test(indices[i]);
+        }
+        return;
     }
-    else if (key.evdev != 0)
+
+    // m_lastDownNs[0] stays 0, so unbound elements never satisfy the hold window
+    uint64_t minPressNs = static_cast<uint64_t>(config.minPressDurationMs) * 1000000ull;
+    for (size_t i = 0; i < count; ++i)
     {
-        virtualKey = ConvertEvdevToVirtualKey(key.evdev);
+        uint8_t index = indices[i];
+        bool held = m_frameTimeNs - m_lastDownNs[index] < minPressNs && m_lastDownNs[index] != 0;
+        config.elements[i].isPressed = visible.Test(index) | held;
     }
-
-    if (virtualKey == 0)
-        return false;
-
-    auto it = m_keyStates.find(virtualKey);
-    return (it != m_keyStates.end()) ? it->second : false;
 }
 
 bool InputDetection::IsMouseButtonPressed(int button)
@@ -277,68 +289,4 @@ int InputDetection::GetMouseWheelDelta()
 void InputDetection::Cleanup()
 {
     Shutdown();
-}
-
-int InputDetection::ConvertHIDToVirtualKey(int hidCode)
-{
-    for (int i = 0; HID_VK_TABLE[i].hid != 0; ++i)
-    {
-        if (HID_VK_TABLE[i].hid == hidCode)
-        {
-            return HID_VK_TABLE[i].vk;
-        }
-    }
-    return 0; // Not found
-}
-
-int InputDetection::ConvertEvdevToVirtualKey(int evdevCode)
-{
-    // Basic evdev to VK conversion
-    // This is a simplified mapping - a full implementation would have more codes
-    switch (evdevCode)
-    {
-    case 1: return VK_ESCAPE;
-    case 2: return '1';
-    case 3: return '2';
-    case 4: return '3';
-    case 5: return '4';
-    case 6: return '5';
-    case 7: return '6';
-    case 8: return '7';
-    case 9: return '8';
-    case 10: return '9';
-    case 11: return '0';
-    case 16: return 'Q';
-    case 17: return 'W';
-    case 18: return 'E';
-    case 19: return 'R';
-    case 20: return 'T';
-    case 21: return 'Y';
-    case 22: return 'U';
-    case 23: return 'I';
-    case 24: return 'O';
-    case 25: return 'P';
-    case 30: return 'A';
-    case 31: return 'S';
-    case 32: return 'D';
-    case 33: return 'F';
-    case 34: return 'G';
-    case 35: return 'H';
-    case 36: return 'J';
-    case 37: return 'K';
-    case 38: return 'L';
-    case 44: return 'Z';
-    case 45: return 'X';
-    case 46: return 'C';
-    case 47: return 'V';
-    case 48: return 'B';
-    case 49: return 'N';
-    case 50: return 'M';
-    case 57: return VK_SPACE;
-    case 103: return VK_UP;
-    case 105: return VK_LEFT;
-    case 106: return VK_RIGHT;
-    case 108: return VK_DOWN;
-    default: return 0;
-    }
 }
\ No newline at end of file
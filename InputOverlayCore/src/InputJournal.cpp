@@ -0,0 +1,50 @@
+#include "../include/InputJournal.h"
+#include <algorithm>
+
+InputJournal::InputJournal(size_t capacity)
+    : m_mask(0)
+    , m_head(0)
+{
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    m_slots.reset(new Slot[size]());
+    m_mask = size - 1;
+}
+
+InputJournal::~InputJournal()
+{
+}
+
+size_t InputJournal::Copy(uint64_t cursor, InputRecord* records, size_t maxCount) const
+{
+    uint64_t head = GetHead();
+    if (cursor >= head)
+        return 0;
+
+    size_t count = std::min(static_cast<size_t>(head - cursor), maxCount);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Slot& slot = m_slots[(cursor + i) & m_mask];
+        uint32_t low = slot.words[0].load(std::memory_order_relaxed);
+        uint32_t high = slot.words[1].load(std::memory_order_relaxed);
+        uint32_t codes = slot.words[2].load(std::memory_order_relaxed);
+
+        InputRecord& record = records[i];
+        record.timestampNs = low | (static_cast<uint64_t>(high) << 32);
+        record.code = static_cast<uint16_t>(codes);
+        record.device = static_cast<uint16_t>(codes >> 16);
+        record.down = static_cast<uint8_t>(slot.words[3].load(std::memory_order_relaxed));
+        std::fill(std::begin(record.reserved), std::end(record.reserved), 0);
+    }
+    return count;
+}
+
+bool InputJournal::IsIntact(uint64_t cursor) const
+{
+    // Slot 'cursor' is reused by sequence cursor + Capacity(), whose write
+    // starts once the head reaches it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return m_head.load(std::memory_order_relaxed) < cursor + Capacity();
+}
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include "../include/InputRecording.h"
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+    const size_t FLUSH_THRESHOLD = 64 * 1024;
+    const uint8_t TAG_TYPE_MASK = 0x03;
+    const uint8_t TAG_HAS_DEVICE = 0x04;
+
+    size_t WriteVarint(uint64_t value, uint8_t* out)
+    {
+        size_t length = 0;
+        while (value >= 0x80)
+        {
+            out[length++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        out[length++] = static_cast<uint8_t>(value);
+        return length;
+    }
+
+    bool ReadVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (cursor == end)
+                return false;
+
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    uint32_t ZigZagEncode(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t ZigZagDecode(uint32_t value)
+    {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    void WriteUInt16(uint16_t value, uint8_t* out)
+    {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void WriteUInt64(uint64_t value, uint8_t* out)
+    {
+        for (int i = 0; i < 8; ++i)
+            out[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+
+    uint16_t ReadUInt16(const uint8_t* in)
+    {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+
+    uint64_t ReadUInt64(const uint8_t* in)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= static_cast<uint64_t>(in[i]) << (i * 8);
+        return value;
+    }
+}
+
+namespace InputRecording
+{
+    size_t EncodeEvent(const InputEvent& event, uint64_t previousTimestampNs, uint8_t* out)
+    {
+        uint64_t delta = event.timestampNs > previousTimestampNs ? event.timestampNs - previousTimestampNs : 0;
+
+        size_t length = WriteVarint(delta, out);
+
+        uint8_t tag = static_cast<uint8_t>(event.type) & TAG_TYPE_MASK;
+        if (event.device != 0)
+            tag |= TAG_HAS_DEVICE;
+        out[length++] = tag;
+
+        if (event.device != 0)
+            length += WriteVarint(event.device, out + length);
+
+        length += WriteVarint(static_cast<uint32_t>(event.code), out + length);
+        length += WriteVarint(ZigZagEncode(event.value), out + length);
+        return length;
+    }
+
+    bool DecodeEvent(const uint8_t*& cursor, const uint8_t* end, uint64_t previousTimestampNs, InputEvent& event)
+    {
+        uint64_t delta = 0;
+        if (!ReadVarint(cursor, end, delta) || cursor == end)
+            return false;
+
+        uint8_t tag = *cursor++;
+        uint8_t type = tag & TAG_TYPE_MASK;
+        if (type > static_cast<uint8_t>(InputEventType::Absolute))
+            return false;
+
+        uint64_t device = 0;
+        if ((tag & TAG_HAS_DEVICE) && !ReadVarint(cursor, end, device))
+            return false;
+
+        uint64_t code = 0;
+        uint64_t value = 0;
+        if (!ReadVarint(cursor, end, code) || !ReadVarint(cursor, end, value))
+            return false;
+
+        event.timestampNs = previousTimestampNs + delta;
+        event.type = static_cast<InputEventType>(type);
+        event.device = static_cast<uint16_t>(device);
+        event.code = static_cast<int>(code);
+        event.value = ZigZagDecode(static_cast<uint32_t>(value));
+        return true;
+    }
+}
+
+// InputRecorder
+
+InputRecorder::InputRecorder()
+    : m_previousTimestampNs(0)
+    , m_eventCount(0)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    Close();
+}
+
+bool InputRecorder::Open(const std::string& filePath)
+{
+    Close();
+
+    m_file.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        std::cerr << "Failed to create recording: " << filePath << std::endl;
+        return false;
+    }
+
+    m_previousTimestampNs = GetInputTimestampNs();
+    m_eventCount = 0;
+    m_buffer.clear();
+    m_buffer.reserve(FLUSH_THRESHOLD + InputRecording::MAX_RECORD_SIZE);
+
+    // The header goes straight into the (empty) buffer, like the records after it
+    m_buffer.resize(InputRecording::HEADER_SIZE);
+    uint8_t* header = m_buffer.data();
+    std::copy(InputRecording::MAGIC, InputRecording::MAGIC + 4, header);
+    WriteUInt16(InputRecording::VERSION, header + 4);
+    WriteUInt16(static_cast<uint16_t>(InputRecording::HEADER_SIZE), header + 6);
+    WriteUInt64(m_previousTimestampNs, header + 8);
+
+    std::cout << "Recording input to " << filePath << std::endl;
+    return true;
+}
+
+void InputRecorder::Close()
+{
+    if (!m_file.is_open())
+        return;
+
+    Flush();
+    m_file.close();
+    std::cout << "Recorded " << m_eventCount << " input events." << std::endl;
+}
+
+void InputRecorder::Record(const InputEvent& event)
+{
+    if (!m_file.is_open())
+        return;
+
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + InputRecording::MAX_RECORD_SIZE);
+    size_t length = InputRecording::EncodeEvent(event, m_previousTimestampNs, m_buffer.data() + offset);
+    m_buffer.resize(offset + length);
+
+    m_previousTimestampNs = std::max(m_previousTimestampNs, event.timestampNs);
+    ++m_eventCount;
+
+    if (m_buffer.size() >= FLUSH_THRESHOLD)
+        Flush();
+}
+
+void InputRecorder::Record(const std::vector<InputEvent>& events)
+{
+    for (const auto& event : events)
+    {
+        Record(event);
+    }
+}
+
+void InputRecorder::Flush()
+{
+    if (m_buffer.empty())
+        return;
+
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+// ReplayInputBackend
+
+ReplayInputBackend::ReplayInputBackend(const std::string& filePath, ReplayMode mode, uint64_t frameStepNs)
+    : m_filePath(filePath)
+    , m_mode(mode)
+    , m_frameStepNs(frameStepNs)
+    , m_cursor(nullptr)
+    , m_end(nullptr)
+    , m_recordStartNs(0)
+    , m_previousTimestampNs(0)
+    , m_playbackStartNs(0)
+    , m_virtualTimeNs(0)
+    , m_eventCount(0)
+    , m_hasNextEvent(false)
+{
+}
+
+ReplayInputBackend::~ReplayInputBackend()
+{
+    Shutdown();
+}
+
+bool ReplayInputBackend::Initialize()
+{
+    if (!m_file.Open(m_filePath))
+    {
+        std::cerr << "Failed to open recording: " << m_filePath << std::endl;
+        return false;
+    }
+
+    const uint8_t* data = m_file.Data();
+    if (m_file.Size() < InputRecording::HEADER_SIZE ||
+        !std::equal(InputRecording::MAGIC, InputRecording::MAGIC + 4, data))
+    {
+        std::cerr << "Not an input recording: " << m_filePath << std::endl;
+        m_file.Close();
+        return false;
+    }
+
+    uint16_t version = ReadUInt16(data + 4);
+    uint16_t headerSize = ReadUInt16(data + 6);
+    if (version != InputRecording::VERSION || headerSize < InputRecording::HEADER_SIZE || headerSize > m_file.Size())
+    {
+        std::cerr << "Unsupported recording version " << version << ": " << m_filePath << std::endl;
+        m_file.Close();
+        return false;
+    }
+
+    m_recordStartNs = ReadUInt64(data + 8);
+    m_previousTimestampNs = m_recordStartNs;
+    m_cursor = data + headerSize;
+    m_end = data + m_file.Size();
+    m_playbackStartNs = GetInputTimestampNs();
+    m_virtualTimeNs = m_recordStartNs;
+    m_eventCount = 0;
+    m_hasNextEvent = false;
+
+    DecodeNext();
+    return true;
+}
+
+void ReplayInputBackend::Shutdown()
+{
+    m_file.Close();
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_hasNextEvent = false;
+}
+
+uint64_t ReplayInputBackend::GetTimeNs() const
+{
+    if (m_mode == ReplayMode::Fast)
+        return m_virtualTimeNs;
+
+    return GetInputTimestampNs();
+}
+
+bool ReplayInputBackend::DecodeNext()
+{
+    m_hasNextEvent = false;
+    if (m_cursor == m_end)
+        return false;
+
+    if (!InputRecording::DecodeEvent(m_cursor, m_end, m_previousTimestampNs, m_nextEvent))
+    {
+        std::cerr << "Truncated input recording: " << m_filePath << std::endl;
+        m_cursor = m_end;
+        return false;
+    }
+
+    m_previousTimestampNs = m_nextEvent.timestampNs;
+    m_hasNextEvent = true;
+    return true;
+}
+
+void ReplayInputBackend::Poll(std::vector<InputEvent>& events)
+{
+    // Everything up to 'due' (in recording time) is delivered this call
+    uint64_t due;
+    if (m_mode == ReplayMode::Fast)
+    {
+        m_virtualTimeNs += m_frameStepNs;
+        due = m_virtualTimeNs;
+    }
+    else
+    {
+        due = m_recordStartNs + (GetInputTimestampNs() - m_playbackStartNs);
+    }
+
+    while (m_hasNextEvent && m_nextEvent.timestampNs <= due)
+    {
+        InputEvent event = m_nextEvent;
+
+        // Realtime playback reports events on the live clock
+        if (m_mode == ReplayMode::Realtime)
+            event.timestampNs = m_playbackStartNs + (event.timestampNs - m_recordStartNs);
+
+        events.push_back(event);
+        ++m_eventCount;
+        DecodeNext();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,651 @@
+#include "../include/JSONDocument.h"
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    const int MAX_DEPTH = 256;
+
+    bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    void AppendUTF8(std::string& out, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+}
+
+// JSONDocument
+
+JSONDocument::JSONDocument()
+    : m_errorOffset(0)
+    , m_pos(0)
+    , m_depth(0)
+{
+}
+
+bool JSONDocument::Parse(std::string_view text)
+{
+    m_text.assign(text.data(), text.size());
+    m_unescaped.clear();
+    m_nodes.clear();
+    m_error.clear();
+    m_errorOffset = 0;
+    m_pos = 0;
+    m_depth = 0;
+
+    if (m_text.size() >= UINT32_MAX)
+        return Fail("document too large");
+
+    // Rough upper bound for typical configs: one node per ~6 bytes of text
+    m_nodes.reserve(m_text.size() / 6 + 1);
+
+    SkipWhitespace();
+    if (!ParseValue())
+    {
+        m_nodes.clear();
+        return false;
+    }
+
+    SkipWhitespace();
+    if (m_pos != m_text.size())
+    {
+        Fail("unexpected data after the root value");
+        m_nodes.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void JSONDocument::GetLineColumn(size_t offset, int& line, int& column) const
+{
+    line = 1;
+    column = 1;
+
+    size_t end = std::min(offset, m_text.size());
+    for (size_t i = 0; i < end; ++i)
+    {
+        if (m_text[i] == '\n')
+        {
+            ++line;
+            column = 1;
+        }
+        else
+        {
+            ++column;
+        }
+    }
+}
+
+bool JSONDocument::Fail(const char* message)
+{
+    if (m_error.empty())
+    {
+        m_error = message;
+        m_errorOffset = m_pos;
+    }
+    return false;
+}
+
+void JSONDocument::SkipWhitespace()
+{
+    while (m_pos < m_text.size())
+    {
+        char c = m_text[m_pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+        ++m_pos;
+    }
+}
+
+bool JSONDocument::ParseValue()
+{
+    if (m_pos >= m_text.size())
+        return Fail("unexpected end of input");
+
+    switch (m_text[m_pos])
+    {
+    case '{': return ParseObject();
+    case '[': return ParseArray();
+    case '"': return ParseString();
+    case 't': return ParseLiteral("true", JSONType::Bool, true);
+    case 'f': return ParseLiteral("false", JSONType::Bool, false);
+    case 'n': return ParseLiteral("null", JSONType::Null, false);
+    default:
+        if (m_text[m_pos] == '-' || IsDigit(m_text[m_pos]))
+            return ParseNumber();
+        return Fail("unexpected character");
+    }
+}
+
+bool JSONDocument::ParseObject()
+{
+    if (++m_depth > MAX_DEPTH)
+        return Fail("nesting too deep");
+
+    uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+    m_nodes[index].type = JSONType::Object;
+    m_nodes[index].offset = static_cast<uint32_t>(m_pos);
+    ++m_pos; // '{'
+
+    uint32_t count = 0;
+    SkipWhitespace();
+    if (m_pos < m_text.size() && m_text[m_pos] == '}')
+    {
+        ++m_pos;
+    }
+    else
+    {
+        while (true)
+        {
+            SkipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+                return Fail("expected member name");
+            if (!ParseString())
+                return false;
+
+            SkipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != ':')
+                return Fail("expected ':' after member name");
+            ++m_pos;
+
+            SkipWhitespace();
+            if (!ParseValue())
+                return false;
+            ++count;
+
+            SkipWhitespace();
+            if (m_pos >= m_text.size())
+                return Fail("unterminated object");
+            if (m_text[m_pos] == ',')
+            {
+                ++m_pos;
+                continue;
+            }
+            if (m_text[m_pos] == '}')
+            {
+                ++m_pos;
+                break;
+            }
+            return Fail("expected ',' or '}' in object");
+        }
+    }
+
+    m_nodes[index].length = count;
+    m_nodes[index].end = static_cast<uint32_t>(m_nodes.size());
+    --m_depth;
+    return true;
+}
+
+bool JSONDocument::ParseArray()
+{
+    if (++m_depth > MAX_DEPTH)
+        return Fail("nesting too deep");
+
+    uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+    m_nodes[index].type = JSONType::Array;
+    m_nodes[index].offset = static_cast<uint32_t>(m_pos);
+    ++m_pos; // '['
+
+    uint32_t count = 0;
+    SkipWhitespace();
+    if (m_pos < m_text.size() && m_text[m_pos] == ']')
+    {
+        ++m_pos;
+    }
+    else
+    {
+        while (true)
+        {
+            SkipWhitespace();
+            if (!ParseValue())
+                return false;
+            ++count;
+
+            SkipWhitespace();
+            if (m_pos >= m_text.size())
+                return Fail("unterminated array");
+            if (m_text[m_pos] == ',')
+            {
+                ++m_pos;
+                continue;
+            }
+            if (m_text[m_pos] == ']')
+            {
+                ++m_pos;
+                break;
+            }
+            return Fail("expected ',' or ']' in array");
+        }
+    }
+
+    m_nodes[index].length = count;
+    m_nodes[index].end = static_cast<uint32_t>(m_nodes.size());
+    --m_depth;
+    return true;
+}
+
+bool JSONDocument::ParseString()
+{
+    ++m_pos; // '"'
+
+    Node node = Node();
+    node.type = JSONType::String;
+    node.offset = static_cast<uint32_t>(m_pos);
+
+    // Fast path: scan to the closing quote; only escaped strings are copied
+    size_t start = m_pos;
+    while (m_pos < m_text.size())
+    {
+        unsigned char c = static_cast<unsigned char>(m_text[m_pos]);
+        if (c == '"' || c == '\\')
+            break;
+        if (c < 0x20)
+            return Fail("control character in string");
+        ++m_pos;
+    }
+
+    if (m_pos >= m_text.size())
+        return Fail("unterminated string");
+
+    if (m_text[m_pos] == '"')
+    {
+        node.length = static_cast<uint32_t>(m_pos - start);
+    }
+    else
+    {
+        size_t unescapedStart = m_unescaped.size();
+        m_unescaped.append(m_text, start, m_pos - start);
+
+        while (true)
+        {
+            if (m_pos >= m_text.size())
+                return Fail("unterminated string");
+
+            char c = m_text[m_pos];
+            if (c == '"')
+                break;
+
+            if (static_cast<unsigned char>(c) < 0x20)
+                return Fail("control character in string");
+
+            if (c != '\\')
+            {
+                m_unescaped += c;
+                ++m_pos;
+                continue;
+            }
+
+            if (++m_pos >= m_text.size())
+                return Fail("unterminated string");
+
+            char escape = m_text[m_pos++];
+            switch (escape)
+            {
+            case '"': m_unescaped += '"'; break;
+            case '\\': m_unescaped += '\\'; break;
+            case '/': m_unescaped += '/'; break;
+            case 'b': m_unescaped += '\b'; break;
+            case 'f': m_unescaped += '\f'; break;
+            case 'n': m_unescaped += '\n'; break;
+            case 'r': m_unescaped += '\r'; break;
+            case 't': m_unescaped += '\t'; break;
+            case 'u':
+            {
+                uint32_t codePoint = 0;
+                if (!ParseHexQuad(codePoint))
+                    return false;
+
+                // Surrogate pair
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                {
+                    uint32_t low = 0;
+                    if (m_pos + 1 >= m_text.size() || m_text[m_pos] != '\\' || m_text[m_pos + 1] != 'u')
+                        return Fail("unpaired surrogate in string");
+                    m_pos += 2;
+                    if (!ParseHexQuad(low))
+                        return false;
+                    if (low < 0xDC00 || low > 0xDFFF)
+                        return Fail("invalid surrogate pair in string");
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+                {
+                    return Fail("unpaired surrogate in string");
+                }
+
+                AppendUTF8(m_unescaped, codePoint);
+                break;
+            }
+            default:
+                --m_pos;
+                return Fail("invalid escape sequence");
+            }
+        }
+
+        node.flags = NODE_ESCAPED;
+        node.integer = static_cast<int64_t>(unescapedStart);
+        node.length = static_cast<uint32_t>(m_unescaped.size() - unescapedStart);
+    }
+
+    ++m_pos; // '"'
+    node.end = static_cast<uint32_t>(m_nodes.size() + 1);
+    m_nodes.push_back(node);
+    return true;
+}
+
+bool JSONDocument::ParseHexQuad(uint32_t& codePoint)
+{
+    if (m_pos + 4 > m_text.size())
+        return Fail("truncated \\u escape");
+
+    codePoint = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = m_text[m_pos++];
+        codePoint <<= 4;
+        if (c >= '0' && c <= '9') codePoint |= c - '0';
+        else if (c >= 'a' && c <= 'f') codePoint |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') codePoint |= c - 'A' + 10;
+        else return Fail("invalid \\u escape");
+    }
+    return true;
+}
+
+bool JSONDocument::ParseNumber()
+{
+    size_t start = m_pos;
+    bool isInteger = true;
+
+    if (m_text[m_pos] == '-')
+        ++m_pos;
+
+    if (m_pos >= m_text.size() || !IsDigit(m_text[m_pos]))
+        return Fail("invalid number");
+
+    // No leading zeros
+    if (m_text[m_pos] == '0')
+    {
+        ++m_pos;
+    }
+    else
+    {
+        while (m_pos < m_text.size() && IsDigit(m_text[m_pos]))
+            ++m_pos;
+    }
+
+    if (m_pos < m_text.size() && m_text[m_pos] == '.')
+    {
+        isInteger = false;
+        ++m_pos;
+        if (m_pos >= m_text.size() || !IsDigit(m_text[m_pos]))
+            return Fail("invalid number");
+        while (m_pos < m_text.size() && IsDigit(m_text[m_pos]))
+            ++m_pos;
+    }
+
+    if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E'))
+    {
+        isInteger = false;
+        ++m_pos;
+        if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-'))
+            ++m_pos;
+        if (m_pos >= m_text.size() || !IsDigit(m_text[m_pos]))
+            return Fail("invalid number");
+        while (m_pos < m_text.size() && IsDigit(m_text[m_pos]))
+            ++m_pos;
+    }
+
+    Node node = Node();
+    node.type = JSONType::Number;
+    node.offset = static_cast<uint32_t>(start);
+    node.end = static_cast<uint32_t>(m_nodes.size() + 1);
+
+    const char* first = m_text.data() + start;
+    const char* last = m_text.data() + m_pos;
+
+    if (isInteger)
+    {
+        int64_t value = 0;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc())
+        {
+            node.flags = NODE_INTEGER;
+            node.integer = value;
+        }
+        else
+        {
+            isInteger = false;
+        }
+    }
+
+    if (!isInteger)
+    {
+        double value = 0.0;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            // from_chars leaves 'value' untouched here; strtod saturates to
+            // +-HUGE_VAL or 0, so 1e400 cannot pass as 0 (the core never
+            // changes the C locale, so '.' is the decimal point)
+            value = std::strtod(std::string(first, last).c_str(), nullptr);
+        }
+        else if (result.ec != std::errc())
+        {
+            return Fail("invalid number");
+        }
+        node.real = value;
+    }
+
+    m_nodes.push_back(node);
+    return true;
+}
+
+bool JSONDocument::ParseLiteral(const char* literal, JSONType type, bool value)
+{
+    size_t length = std::strlen(literal);
+    if (m_text.compare(m_pos, length, literal) != 0)
+        return Fail("invalid literal");
+
+    Node node = Node();
+    node.type = type;
+    node.offset = static_cast<uint32_t>(m_pos);
+    node.end = static_cast<uint32_t>(m_nodes.size() + 1);
+    node.boolean = value;
+    m_nodes.push_back(node);
+
+    m_pos += length;
+    return true;
+}
+
+std::string_view JSONDocument::StringAt(uint32_t index) const
+{
+    const Node& node = m_nodes[index];
+    if (node.flags & NODE_ESCAPED)
+        return std::string_view(m_unescaped.data() + node.integer, node.length);
+    return std::string_view(m_text.data() + node.offset, node.length);
+}
+
+uint32_t JSONDocument::FindMember(uint32_t objectIndex, std::string_view key) const
+{
+    const Node& object = m_nodes[objectIndex];
+    uint32_t index = objectIndex + 1;
+    while (index < object.end)
+    {
+        // Member key, then the value's subtree
+        if (StringAt(index) == key)
+            return index + 1;
+        index = m_nodes[index + 1].end;
+    }
+    return UINT32_MAX;
+}
+
+// JSONValue
+
+JSONType JSONValue::GetType() const
+{
+    return m_document ? m_document->m_nodes[m_index].type : JSONType::Invalid;
+}
+
+bool JSONValue::IsInteger() const
+{
+    return IsNumber() && (m_document->m_nodes[m_index].flags & JSONDocument::NODE_INTEGER) != 0;
+}
+
+bool JSONValue::FitsInt() const
+{
+    if (!IsNumber())
+        return false;
+
+    // Written so that NaN and infinities compare false
+    const auto& node = m_document->m_nodes[m_index];
+    if (node.flags & JSONDocument::NODE_INTEGER)
+        return node.integer >= INT_MIN && node.integer <= INT_MAX;
+    return node.real > static_cast<double>(INT_MIN) - 1.0 && node.real < static_cast<double>(INT_MAX) + 1.0;
+}
+
+bool JSONValue::AsBool(bool fallback) const
+{
+    return IsBool() ? m_document->m_nodes[m_index].boolean : fallback;
+}
+
+int JSONValue::AsInt(int fallback) const
+{
+    if (!FitsInt())
+        return fallback;
+
+    const auto& node = m_document->m_nodes[m_index];
+    if (node.flags & JSONDocument::NODE_INTEGER)
+        return static_cast<int>(node.integer);
+    return static_cast<int>(node.real);
+}
+
+double JSONValue::AsDouble(double fallback) const
+{
+    if (!IsNumber())
+        return fallback;
+
+    const auto& node = m_document->m_nodes[m_index];
+    if (node.flags & JSONDocument::NODE_INTEGER)
+        return static_cast<double>(node.integer);
+    return node.real;
+}
+
+std::string_view JSONValue::AsStringView() const
+{
+    return IsString() ? m_document->StringAt(m_index) : std::string_view();
+}
+
+std::string JSONValue::AsString(const std::string& fallback) const
+{
+    if (!IsString())
+        return fallback;
+
+    std::string_view text = m_document->StringAt(m_index);
+    return std::string(text.data(), text.size());
+}
+
+JSONValue JSONValue::operator[](std::string_view key) const
+{
+    if (!IsObject())
+        return JSONValue();
+
+    uint32_t index = m_document->FindMember(m_index, key);
+    return index == UINT32_MAX ? JSONValue() : JSONValue(m_document, index);
+}
+
+size_t JSONValue::Size() const
+{
+    if (!IsArray() && !IsObject())
+        return 0;
+    return m_document->m_nodes[m_index].length;
+}
+
+JSONValue JSONValue::At(size_t index) const
+{
+    if (!IsArray() || index >= Size())
+        return JSONValue();
+
+    uint32_t node = m_index + 1;
+    for (size_t i = 0; i < index; ++i)
+        node = m_document->m_nodes[node].end;
+    return JSONValue(m_document, node);
+}
+
+size_t JSONValue::GetInts(int* out, size_t count) const
+{
+    if (!IsArray())
+        return 0;
+
+    size_t read = 0;
+    for (JSONValue item : *this)
+    {
+        if (read == count || !item.FitsInt())
+            break;
+        out[read++] = item.AsInt();
+    }
+    return read;
+}
+
+size_t JSONValue::GetOffset() const
+{
+    return m_document ? m_document->m_nodes[m_index].offset : 0;
+}
+
+JSONValue::Iterator JSONValue::begin() const
+{
+    if (!IsArray() && !IsObject())
+        return end();
+    return Iterator(m_document, m_index + 1, IsObject());
+}
+
+JSONValue::Iterator JSONValue::end() const
+{
+    uint32_t endIndex = m_document ? m_document->m_nodes[m_index].end : 0;
+    return Iterator(m_document, endIndex, IsObject());
+}
+
+JSONValue JSONValue::Iterator::operator*() const
+{
+    return JSONValue(m_document, m_object ? m_index + 1 : m_index);
+}
+
+JSONValue::Iterator& JSONValue::Iterator::operator++()
+{
+    uint32_t value = m_object ? m_index + 1 : m_index;
+    m_index = m_document->m_nodes[value].end;
+    return *this;
+}
+
+std::string_view JSONValue::Iterator::Key() const
+{
+    return m_object ? m_document->StringAt(m_index) : std::string_view();
+}
\ No newline at end of file
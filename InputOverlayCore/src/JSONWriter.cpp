@@ -0,0 +1,264 @@
+#include "../include/JSONWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+JSONWriter::JSONWriter(std::string& out, bool pretty)
+    : m_out(&out)
+    , m_size(out.size())
+    , m_stream(nullptr)
+    , m_flushThreshold(0)
+    , m_pretty(pretty)
+    , m_depth(0)
+    , m_hasMembers(0)
+    , m_afterKey(false)
+{
+}
+
+JSONWriter::JSONWriter(std::ostream& stream, bool pretty, size_t flushThreshold)
+    : m_out(&m_buffer)
+    , m_size(0)
+    , m_stream(&stream)
+    , m_flushThreshold(flushThreshold)
+    , m_pretty(pretty)
+    , m_depth(0)
+    , m_hasMembers(0)
+    , m_afterKey(false)
+{
+    m_buffer.resize(flushThreshold + 4096);
+}
+
+JSONWriter::~JSONWriter()
+{
+    Flush();
+}
+
+bool JSONWriter::Flush()
+{
+    if (!m_stream)
+    {
+        m_out->resize(m_size);
+        return true;
+    }
+
+    if (m_size > 0)
+    {
+        m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+        m_size = 0;
+    }
+    return m_stream->good();
+}
+
+char* JSONWriter::Reserve(size_t count)
+{
+    if (m_size + count > m_out->size())
+    {
+        if (m_stream && m_size > 0)
+        {
+            Flush();
+        }
+
+        // Grow geometrically; the unwritten tail is trimmed by Flush()
+        if (m_size + count > m_out->size())
+        {
+            m_out->resize(std::max(m_out->size() * 2, m_size + count + 4096));
+        }
+    }
+    return &(*m_out)[m_size];
+}
+
+void JSONWriter::Append(const char* text, size_t length)
+{
+    std::memcpy(Reserve(length), text, length);
+    m_size += length;
+}
+
+uint64_t JSONWriter::DepthBit() const
+{
+    // Levels past 64 share the last bit; configs nest four deep
+    int level = m_depth < MAX_DEPTH ? m_depth : MAX_DEPTH;
+    return 1ull << (level - 1);
+}
+
+void JSONWriter::BeginValue()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_depth == 0)
+        return;
+
+    uint64_t bit = DepthBit();
+    size_t indent = m_pretty ? static_cast<size_t>(m_depth) * 2 : 0;
+    char* out = Reserve(indent + 2);
+
+    if (m_hasMembers & bit)
+    {
+        *out++ = ',';
+    }
+    m_hasMembers |= bit;
+
+    if (m_pretty)
+    {
+        *out++ = '\n';
+        std::memset(out, ' ', indent);
+        out += indent;
+    }
+
+    m_size = static_cast<size_t>(out - m_out->data());
+}
+
+void JSONWriter::BeginContainer(char open)
+{
+    BeginValue();
+    Append(&open, 1);
+
+    ++m_depth;
+    m_hasMembers &= ~DepthBit();
+}
+
+void JSONWriter::EndContainer(char close)
+{
+    if (m_depth > 0)
+    {
+        bool hadMembers = (m_hasMembers & DepthBit()) != 0;
+        --m_depth;
+
+        if (m_pretty && hadMembers)
+        {
+            size_t indent = static_cast<size_t>(m_depth) * 2;
+            char* out = Reserve(indent + 1);
+            *out++ = '\n';
+            std::memset(out, ' ', indent);
+            m_size += indent + 1;
+        }
+    }
+
+    Append(&close, 1);
+
+    if (m_stream && m_size >= m_flushThreshold)
+    {
+        Flush();
+    }
+}
+
+void JSONWriter::BeginObject()
+{
+    BeginContainer('{');
+}
+
+void JSONWriter::EndObject()
+{
+    EndContainer('}');
+}
+
+void JSONWriter::BeginArray()
+{
+    BeginContainer('[');
+}
+
+void JSONWriter::EndArray()
+{
+    EndContainer(']');
+}
+
+void JSONWriter::Key(std::string_view key)
+{
+    String(key);
+    if (m_pretty)
+        Append(": ", 2);
+    else
+        Append(":", 1);
+    m_afterKey = true;
+}
+
+void JSONWriter::String(std::string_view value)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    BeginValue();
+
+    // Worst case every byte becomes \u00XX
+    char* out = Reserve(value.size() * 6 + 2);
+    *out++ = '"';
+
+    for (char ch : value)
+    {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            *out++ = ch;
+            continue;
+        }
+
+        *out++ = '\\';
+        switch (c)
+        {
+        case '"':  *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '\n': *out++ = 'n'; break;
+        case '\r': *out++ = 'r'; break;
+        case '\t': *out++ = 't'; break;
+        case '\b': *out++ = 'b'; break;
+        case '\f': *out++ = 'f'; break;
+        default:
+            *out++ = 'u';
+            *out++ = '0';
+            *out++ = '0';
+            *out++ = hex[c >> 4];
+            *out++ = hex[c & 0xF];
+            break;
+        }
+    }
+
+    *out++ = '"';
+    m_size = static_cast<size_t>(out - m_out->data());
+}
+
+void JSONWriter::Int(int64_t value)
+{
+    BeginValue();
+
+    char* out = Reserve(MAX_INT_CHARS);
+    out = std::to_chars(out, out + MAX_INT_CHARS, value).ptr;
+    m_size = static_cast<size_t>(out - m_out->data());
+}
+
+void JSONWriter::Bool(bool value)
+{
+    BeginValue();
+    if (value)
+        Append("true", 4);
+    else
+        Append("false", 5);
+}
+
+void JSONWriter::Null()
+{
+    BeginValue();
+    Append("null", 4);
+}
+
+void JSONWriter::IntArray(const int* values, size_t count)
+{
+    BeginValue();
+
+    // "[", then each value with its separator, then "]"
+    char* out = Reserve(2 + count * (MAX_INT_CHARS + 2));
+    *out++ = '[';
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i > 0)
+        {
+            *out++ = ',';
+            if (m_pretty)
+                *out++ = ' ';
+        }
+        out = std::to_chars(out, out + MAX_INT_CHARS, values[i]).ptr;
+    }
+    *out++ = ']';
+    m_size = static_cast<size_t>(out - m_out->data());
+}
\ No newline at end of file
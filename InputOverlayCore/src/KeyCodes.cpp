@@ -0,0 +1,46 @@
+#include "../include/KeyCodes.h"
+
+namespace KeyCodes
+{
+    int ResolveInputKey(const InputKey& key)
+    {
+        int virtualKey = 0;
+
+        // Priority: WinVK > HID > Evdev
+        if (key.winvk != 0)
+        {
+            virtualKey = key.winvk;
+        }
+        else if (key.hid != 0)
+        {
+            virtualKey = HIDToVirtualKey(key.hid);
+        }
+        else if (key.evdev != 0)
+        {
+            virtualKey = EvdevToVirtualKey(key.evdev);
+        }
+
+        if (virtualKey <= 0 || virtualKey >= VK_CODE_LIMIT)
+            return 0;
+
+        return virtualKey;
+    }
+
+    int GenericModifier(int virtualKey)
+    {
+        switch (virtualKey)
+        {
+        case VK_LSHIFT:
+        case VK_RSHIFT:
+            return VK_SHIFT;
+        case VK_LCONTROL:
+        case VK_RCONTROL:
+            return VK_CONTROL;
+        case VK_LMENU:
+        case VK_RMENU:
+            return VK_MENU;
+        default:
+            return 0;
+        }
+    }
+}
\ No newline at end of file
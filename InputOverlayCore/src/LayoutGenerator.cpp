@@ -0,0 +1,282 @@
+#include "../include/LayoutGenerator.h"
+#include "../include/ConfigArena.h"
+#include "../include/ConfigParser.h"
+#include "../include/KeyCodes.h"
+#include "../include/PresetCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+
+namespace
+{
+    const int DEFAULT_KEY_SIZE = 50;
+    const int DEFAULT_SPACING = 4;
+
+    // Full-size ANSI keyboard: function row, main block, navigation cluster, numpad
+    const char* const ANSI104_LAYOUT = R"({ "rows": [
+        "escape _ f1 f2 f3 f4 _:0.5 f5 f6 f7 f8 _:0.5 f9 f10 f11 f12 _:0.25 print_screen scroll_lock pause",
+        0.5,
+        "grave 1 2 3 4 5 6 7 8 9 0 minus equal backspace:2 _:0.25 insert home page_up _:0.25 num_lock kp_divide kp_multiply kp_subtract",
+        "tab:1.5 q w e r t y u i o p left_bracket right_bracket backslash:1.5 _:0.25 delete end page_down _:0.25 kp_7 kp_8 kp_9 kp_add:1:2",
+        "caps_lock:1.75 a s d f g h j k l semicolon apostrophe enter:2.25 _:3.5 kp_4 kp_5 kp_6",
+        "left_shift:2.25 z x c v b n m comma period slash right_shift:2.75 _:1.25 up _:1.25 kp_1 kp_2 kp_3 kp_enter:1:2",
+        "left_ctrl:1.25 left_meta:1.25 left_alt:1.25 space:6.25 right_alt:1.25 right_meta:1.25 menu:1.25 right_ctrl:1.25 _:0.25 left down right _:0.25 kp_0:2 kp_decimal"
+    ] })";
+
+    // 60%: the main block only, Escape in place of the grave key
+    const char* const ANSI60_LAYOUT = R"({ "rows": [
+        "escape 1 2 3 4 5 6 7 8 9 0 minus equal backspace:2",
+        "tab:1.5 q w e r t y u i o p left_bracket right_bracket backslash:1.5",
+        "caps_lock:1.75 a s d f g h j k l semicolon apostrophe enter:2.25",
+        "left_shift:2.25 z x c v b n m comma period slash right_shift:2.75",
+        "left_ctrl:1.25 left_meta:1.25 left_alt:1.25 space:6.25 right_alt:1.25 right_meta:1.25 menu:1.25 right_ctrl:1.25"
+    ] })";
+
+    // A key on the layout grid, in key units
+    struct PlacedKey
+    {
+        const KeyCodes::KeyCodeEntry* entry;
+        double x, y, width, height;
+    };
+
+    // "name", "name:width" or "name:width:height"
+    bool ParseToken(std::string_view token, std::string_view& name, double& width, double& height)
+    {
+        size_t colon = token.find(':');
+        name = token.substr(0, colon);
+        width = 1.0;
+        height = 1.0;
+
+        double* sizes[2] = { &width, &height };
+        for (double* size : sizes)
+        {
+            if (colon == std::string_view::npos)
+                break;
+
+            size_t next = token.find(':', colon + 1);
+            std::string number(token.substr(colon + 1, next == std::string_view::npos ? std::string_view::npos : next - colon - 1));
+            char* end = nullptr;
+            *size = std::strtod(number.c_str(), &end);
+            if (number.empty() || *end != '\0' || !(*size > 0.0))
+                return false;
+            colon = next;
+        }
+        return colon == std::string_view::npos && !name.empty();
+    }
+
+    bool PlaceRow(std::string_view row, size_t rowIndex, double y, std::vector<PlacedKey>& keys, std::set<std::string_view>& names)
+    {
+        double x = 0.0;
+        size_t start = 0;
+        while (start < row.size())
+        {
+            start = row.find_first_not_of(" \t", start);
+            if (start == std::string_view::npos)
+                break;
+            size_t end = std::min(row.find_first_of(" \t", start), row.size());
+            std::string_view token = row.substr(start, end - start);
+            start = end;
+
+            std::string_view name;
+            double width = 0.0;
+            double height = 0.0;
+            if (!ParseToken(token, name, width, height))
+            {
+                std::cerr << "Layout row " << rowIndex << ": malformed key \"" << token << "\"" << std::endl;
+                return false;
+            }
+
+            if (name != "_")
+            {
+                const KeyCodes::KeyCodeEntry* entry = KeyCodes::FindByName(name);
+                if (!entry)
+                {
+                    std::cerr << "Layout row " << rowIndex << ": unknown key \"" << name << "\"" << std::endl;
+                    return false;
+                }
+                if (!names.insert(entry->name).second)
+                {
+                    std::cerr << "Layout row " << rowIndex << ": key \"" << name << "\" is already placed" << std::endl;
+                    return false;
+                }
+                keys.push_back({ entry, x, y, width, height });
+            }
+            x += width;
+        }
+        return true;
+    }
+
+    Vector2i ReadVector(const JSONValue& value, Vector2i fallback)
+    {
+        int xy[2];
+        return value.GetInts(xy, 2) == 2 ? Vector2i(xy[0], xy[1]) : fallback;
+    }
+}
+
+namespace LayoutGenerator
+{
+    const char* FindBuiltinLayout(std::string_view name)
+    {
+        if (name == "ansi104")
+            return ANSI104_LAYOUT;
+        if (name == "ansi60")
+            return ANSI60_LAYOUT;
+        return nullptr;
+    }
+
+    bool Generate(const JSONValue& layout, OverlayConfig& config)
+    {
+        if (!layout.IsObject())
+        {
+            std::cerr << "Layout description must be an object" << std::endl;
+            return false;
+        }
+
+        // Rows of a built-in layout unless the description lists its own
+        JSONDocument builtin;
+        JSONValue rows = layout["rows"];
+        JSONValue base = layout["layout"];
+        if (!rows.IsValid() && base.IsString())
+        {
+            const char* text = FindBuiltinLayout(base.AsStringView());
+            if (!text || !builtin.Parse(text))
+            {
+                std::cerr << "Unknown built-in layout \"" << base.AsStringView() << "\" (ansi104, ansi60)" << std::endl;
+                return false;
+            }
+            rows = builtin.Root()["rows"];
+        }
+
+        if (!rows.IsArray())
+        {
+            std::cerr << "Layout has no rows" << std::endl;
+            return false;
+        }
+
+        std::vector<PlacedKey> keys;
+        std::set<std::string_view> names;
+        double y = 0.0;
+        size_t rowIndex = 0;
+        for (JSONValue row : rows)
+        {
+            ++rowIndex;
+            if (row.IsNumber())
+            {
+                y += row.AsDouble();
+                continue;
+            }
+            if (!row.IsString())
+            {
+                std::cerr << "Layout row " << rowIndex << " must be a string of keys or a number" << std::endl;
+                return false;
+            }
+            if (!PlaceRow(row.AsStringView(), rowIndex, y, keys, names))
+                return false;
+            y += 1.0;
+        }
+
+        Vector2i keySize = ReadVector(layout["key_size"], Vector2i(DEFAULT_KEY_SIZE, DEFAULT_KEY_SIZE));
+        int spacing = std::max(0, layout["spacing"].AsInt(DEFAULT_SPACING));
+        if (keySize.x <= spacing || keySize.y <= spacing)
+        {
+            std::cerr << "Layout key_size must be larger than spacing" << std::endl;
+            return false;
+        }
+
+        JSONValue sheet = layout["sheet"];
+        Vector2i origin = ReadVector(sheet["origin"], Vector2i());
+
+        // Unit edges are rounded, not sizes, so keys of any width line up
+        auto toPixels = [](double units, int unitSize) { return static_cast<int>(std::lround(units * unitSize)); };
+
+        config.elements.reserve(config.elements.size() + keys.size());
+        ConfigArena& arena = ConfigArena::Of(config, keys.size());
+
+        Vector2i extent;
+        for (const PlacedKey& key : keys)
+        {
+            OverlayElement element;
+            element.id = arena.Intern(key.entry->name);
+            element.key.hid = key.entry->hid;
+            element.key.winvk = key.entry->vk;
+            element.key.evdev = key.entry->evdev;
+
+            int left = toPixels(key.x, keySize.x);
+            int top = toPixels(key.y, keySize.y);
+            int width = toPixels(key.x + key.width, keySize.x) - left - spacing;
+            int height = toPixels(key.y + key.height, keySize.y) - top - spacing;
+
+            element.position = Vector2i(left, top);
+            element.sprite.normal = IntRect(origin.x + left, origin.y + top, width, height);
+            extent.x = std::max(extent.x, left + width);
+            extent.y = std::max(extent.y, top + height);
+
+            config.elements.push_back(element);
+        }
+
+        // Pressed sprites default to a second copy of the sheet below the first
+        JSONValue canvas = layout["canvas"];
+        JSONValue texture = layout["texture"];
+        config.version = 1;
+        config.textureFile = texture["file"].AsString();
+        config.canvasSize = ReadVector(canvas["size"], extent);
+        config.defaultPressedOffset = ReadVector(sheet["pressed_offset"], Vector2i(0, extent.y + spacing));
+
+        int background[4];
+        if (canvas["background"].GetInts(background, 4) == 4)
+        {
+            config.backgroundColor = Color(
+                static_cast<unsigned char>(background[0]),
+                static_cast<unsigned char>(background[1]),
+                static_cast<unsigned char>(background[2]),
+                static_cast<unsigned char>(background[3]));
+        }
+
+        // Without a texture size the sheet is assumed to end at the last sprite
+        Vector2i sheetExtent;
+        for (auto& element : config.elements)
+        {
+            element.sprite.ResolveStates(config.defaultPressedOffset);
+            for (const IntRect& rect : element.sprite.states)
+            {
+                sheetExtent.x = std::max(sheetExtent.x, rect.left + rect.width);
+                sheetExtent.y = std::max(sheetExtent.y, rect.top + rect.height);
+            }
+        }
+        config.textureSize = ReadVector(texture["size"], sheetExtent);
+        return true;
+    }
+
+    bool GenerateFromText(std::string_view layoutJson, OverlayConfig& config)
+    {
+        JSONDocument document;
+        if (!document.Parse(layoutJson))
+        {
+            int line = 0;
+            int column = 0;
+            document.GetLineColumn(document.GetErrorOffset(), line, column);
+            std::cerr << "Layout parsing error at line " << line << ", column " << column
+                      << ": " << document.GetError() << std::endl;
+            return false;
+        }
+        return Generate(document.Root(), config);
+    }
+
+    bool Save(const OverlayConfig& config, const std::string& presetPath, bool compile)
+    {
+        ConfigParser parser;
+        std::string json = parser.ConfigToJSON(config, true);
+
+        std::ofstream file(presetPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(json.data(), static_cast<std::streamsize>(json.size())))
+        {
+            std::cerr << "Failed to write preset: " << presetPath << std::endl;
+            return false;
+        }
+        file.close();
+
+        // Keyed to the exact text just written, so loading it is a cache hit
+        return !compile || PresetCache::Save(PresetCache::CachePathFor(presetPath), PresetCache::HashText(json), config);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "../include/MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_data(nullptr)
+    , m_size(0)
+#ifdef _WIN32
+    , m_hFile(INVALID_HANDLE_VALUE)
+    , m_hMapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    // Never lock out the file's owner: hot reload maps presets while an editor
+    // saves them, in place or by renaming over the file, and PresetCache
+    // replaces a cache file another reader may have mapped. A concurrent write
+    // can tear what we read; the watcher reports it and the file is re-read.
+    m_hFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                          nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+        // Empty files cannot be mapped
+        Close();
+        return false;
+    }
+
+    m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_hMapping)
+    {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    m_fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || info.st_size == 0)
+    {
+        // Empty files cannot be mapped
+        Close();
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_data = nullptr;
+    }
+
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    m_size = 0;
+}
+
+#endif
\ No newline at end of file
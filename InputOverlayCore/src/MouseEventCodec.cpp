@@ -0,0 +1,158 @@
+#include "../include/MouseEventCodec.h"
+#include <algorithm>
+
+namespace
+{
+    uint8_t* WriteVarint(uint8_t* out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    // Zigzag keeps small negative deltas short: 0, -1, 1, -2 -> 0, 1, 2, 3
+    uint8_t* WriteSigned(uint8_t* out, int32_t value)
+    {
+        uint32_t bits = static_cast<uint32_t>(value);
+        return WriteVarint(out, (bits << 1) ^ (0u - (bits >> 31)));
+    }
+
+    // Position deltas wrap rather than overflow, so any packet decodes defined
+    int32_t WrappingAdd(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+    }
+
+    int32_t WrappingSub(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+    }
+
+    bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (data == end)
+                return false;
+
+            uint8_t byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool ReadSigned(const uint8_t*& data, const uint8_t* end, int32_t& value)
+    {
+        uint64_t bits;
+        if (!ReadVarint(data, end, bits) || bits > 0xFFFFFFFFu)
+            return false;
+
+        uint32_t zigzag = static_cast<uint32_t>(bits);
+        value = static_cast<int32_t>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+        return true;
+    }
+}
+
+namespace MouseEventCodec
+{
+    size_t Encode(const MouseSample* samples, int count, uint8_t* out)
+    {
+        count = std::min(std::max(count, 0), MAX_SAMPLES);
+
+        uint8_t* cursor = out;
+        *cursor++ = FORMAT_VERSION;
+        cursor = WriteVarint(cursor, static_cast<uint64_t>(count));
+
+        uint64_t previousUs = 0;
+        Vector2i previousPosition;
+        for (int i = 0; i < count; ++i)
+        {
+            const MouseSample& sample = samples[i];
+            bool hasPosition = sample.position != previousPosition;
+            bool hasMovement = sample.movement.x != 0 || sample.movement.y != 0;
+            bool hasWheel = sample.wheelDelta != 0;
+
+            *cursor++ = (sample.buttons & 0x1F) | (hasPosition ? SAMPLE_POSITION : 0) |
+                        (hasMovement ? SAMPLE_MOVEMENT : 0) | (hasWheel ? SAMPLE_WHEEL : 0);
+
+            // Samples are in time order; a clock that went backwards reads as no gap
+            uint64_t timeUs = sample.timestampNs / 1000;
+            cursor = WriteVarint(cursor, timeUs >= previousUs ? timeUs - previousUs : 0);
+            previousUs = std::max(timeUs, previousUs);
+
+            if (hasPosition)
+            {
+                cursor = WriteSigned(cursor, WrappingSub(sample.position.x, previousPosition.x));
+                cursor = WriteSigned(cursor, WrappingSub(sample.position.y, previousPosition.y));
+                previousPosition = sample.position;
+            }
+            if (hasMovement)
+            {
+                cursor = WriteSigned(cursor, sample.movement.x);
+                cursor = WriteSigned(cursor, sample.movement.y);
+            }
+            if (hasWheel)
+                cursor = WriteSigned(cursor, sample.wheelDelta);
+        }
+        return static_cast<size_t>(cursor - out);
+    }
+
+    bool Decode(const uint8_t* data, size_t size, MouseSample* samples, int& count)
+    {
+        const uint8_t* end = data + size;
+        uint64_t sampleCount;
+        if (size < 1 || *data++ != FORMAT_VERSION || !ReadVarint(data, end, sampleCount) ||
+            sampleCount == 0 || sampleCount > static_cast<uint64_t>(MAX_SAMPLES))
+        {
+            return false;
+        }
+
+        uint64_t timeUs = 0;
+        Vector2i position;
+        for (uint64_t i = 0; i < sampleCount; ++i)
+        {
+            if (data == end)
+                return false;
+
+            uint8_t flags = *data++;
+            uint64_t elapsedUs;
+            if (!ReadVarint(data, end, elapsedUs))
+                return false;
+            timeUs += elapsedUs;
+
+            MouseSample& sample = samples[i];
+            sample = MouseSample();
+            sample.timestampNs = timeUs * 1000;
+            sample.buttons = flags & 0x1F;
+
+            if (flags & SAMPLE_POSITION)
+            {
+                int32_t dx, dy;
+                if (!ReadSigned(data, end, dx) || !ReadSigned(data, end, dy))
+                    return false;
+                position.x = WrappingAdd(position.x, dx);
+                position.y = WrappingAdd(position.y, dy);
+            }
+            sample.position = position;
+
+            if ((flags & SAMPLE_MOVEMENT) &&
+                (!ReadSigned(data, end, sample.movement.x) || !ReadSigned(data, end, sample.movement.y)))
+            {
+                return false;
+            }
+
+            if ((flags & SAMPLE_WHEEL) && !ReadSigned(data, end, sample.wheelDelta))
+                return false;
+        }
+
+        count = static_cast<int>(sampleCount);
+        return data == end;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "../include/NamedPipeTransport.h"
+#include <iostream>
+
+#ifdef _WIN32
+
+NamedPipeTransport::NamedPipeTransport()
+    : m_hPipe(INVALID_HANDLE_VALUE)
+    , m_stopEvent(NULL)
+    , m_readEvent(NULL)
+    , m_writeEvent(NULL)
+    , m_shouldStop(false)
+    , m_connected(false)
+{
+}
+
+NamedPipeTransport::~NamedPipeTransport()
+{
+    Shutdown();
+
+    // The reader and writer have returned by now (IPCManager joins them);
+    // the locks wait for any call still on its way out
+    std::scoped_lock lock(m_readMutex, m_writeMutex);
+    if (m_hPipe != INVALID_HANDLE_VALUE)
+    {
+        DisconnectNamedPipe(m_hPipe);
+        CloseHandle(m_hPipe);
+    }
+    for (HANDLE event : { m_stopEvent, m_readEvent, m_writeEvent })
+    {
+        if (event)
+            CloseHandle(event);
+    }
+}
+
+bool NamedPipeTransport::Initialize()
+{
+    // Manual-reset, as overlapped I/O expects; every operation resets its own
+    for (HANDLE* event : { &m_stopEvent, &m_readEvent, &m_writeEvent })
+    {
+        if (!*event)
+            *event = CreateEventA(NULL, TRUE, FALSE, NULL);
+        if (!*event)
+        {
+            std::cerr << "CreateEvent failed: " << GetLastError() << std::endl;
+            return false;
+        }
+    }
+
+    // Clear a stop left by a previous Shutdown()
+    ResetEvent(m_stopEvent);
+    m_shouldStop = false;
+
+    if (m_hPipe != INVALID_HANDLE_VALUE)
+        return true;
+
+    // First, try to clean up any existing pipe with the same name
+    HANDLE testPipe = CreateFileA(
+        PIPE_NAME.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        0,
+        NULL,
+        OPEN_EXISTING,
+        0,
+        NULL
+    );
+
+    if (testPipe != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(testPipe);
+        std::cout << "Warning: Pipe already exists, attempting to create anyway..." << std::endl;
+    }
+
+    m_hPipe = CreateNamedPipeA(
+        PIPE_NAME.c_str(),
+        PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+        PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+        PIPE_UNLIMITED_INSTANCES, // Allow multiple instances to prevent conflicts
+        MAX_MESSAGE_SIZE,
+        MAX_MESSAGE_SIZE,
+        0, // Default timeout
+        NULL // Default security
+    );
+
+    if (m_hPipe == INVALID_HANDLE_VALUE)
+    {
+        DWORD error = GetLastError();
+        std::cerr << "CreateNamedPipe failed: " << error << std::endl;
+
+        if (error == ERROR_ALREADY_EXISTS || error == ERROR_PIPE_BUSY)
+        {
+            std::cerr << "Pipe is already in use. Please ensure no other instances are running." << std::endl;
+            std::cerr << "You may need to run: taskkill //f //im InputOverlayCore.exe" << std::endl;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+void NamedPipeTransport::Shutdown()
+{
+    // Wakes the reader and writer; the pipe itself stays open until the
+    // destructor, so neither thread can see its handle closed or reused
+    m_shouldStop = true;
+    if (m_stopEvent)
+        SetEvent(m_stopEvent);
+}
+
+bool NamedPipeTransport::Complete(BOOL started, OVERLAPPED& overlapped, DWORD& bytes)
+{
+    bytes = 0;
+
+    // Anything else failed without starting; ERROR_MORE_DATA is a read that
+    // completed at once with part of a message
+    if (!started)
+    {
+        DWORD error = GetLastError();
+        if (error != ERROR_IO_PENDING && error != ERROR_MORE_DATA)
+            return false;
+    }
+
+    HANDLE events[2] = { overlapped.hEvent, m_stopEvent };
+    if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+    {
+        // Wait for the cancellation too: 'overlapped' lives on the caller's stack
+        CancelIoEx(m_hPipe, &overlapped);
+        GetOverlappedResult(m_hPipe, &overlapped, &bytes, TRUE);
+        SetLastError(ERROR_OPERATION_ABORTED);
+        return false;
+    }
+
+    return GetOverlappedResult(m_hPipe, &overlapped, &bytes, FALSE) != FALSE;
+}
+
+bool NamedPipeTransport::WaitForClient()
+{
+    std::lock_guard<std::mutex> lock(m_readMutex);
+    while (!m_shouldStop)
+    {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_readEvent;
+        DWORD unused = 0;
+
+        BOOL started = ConnectNamedPipe(m_hPipe, &overlapped);
+        if ((!started && GetLastError() == ERROR_PIPE_CONNECTED) || Complete(started, overlapped, unused))
+        {
+            m_connected = true;
+            return true;
+        }
+
+        DWORD error = GetLastError();
+        if (m_shouldStop)
+            break;
+
+        // A client that connected and closed again before we got to it
+        if (error == ERROR_NO_DATA)
+        {
+            DisconnectNamedPipe(m_hPipe);
+            continue;
+        }
+
+        // Stays without a client until shut down rather than retrying
+        std::cerr << "ConnectNamedPipe failed: " << error << std::endl;
+        WaitForSingleObject(m_stopEvent, INFINITE);
+    }
+    return false;
+}
+
+void NamedPipeTransport::Disconnect()
+{
+    // The reader and writer both call this when the client goes away; a
+    // pending operation of the other one fails and returns
+    if (m_connected.exchange(false))
+        DisconnectNamedPipe(m_hPipe);
+}
+
+bool NamedPipeTransport::Read(std::string& message)
+{
+    std::lock_guard<std::mutex> lock(m_readMutex);
+
+    // Messages larger than MAX_MESSAGE_SIZE arrive in pieces flagged
+    // ERROR_MORE_DATA; each is read straight into 'message', whose capacity
+    // the caller reuses
+    size_t received = 0;
+    for (;;)
+    {
+        message.resize(received + MAX_MESSAGE_SIZE);
+
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_readEvent;
+        DWORD bytesRead = 0;
+        BOOL started = ReadFile(m_hPipe, &message[received], MAX_MESSAGE_SIZE, NULL, &overlapped);
+        bool success = Complete(started, overlapped, bytesRead);
+        DWORD error = success ? 0 : GetLastError();
+        received += bytesRead;
+
+        if (success && bytesRead > 0)
+        {
+            message.resize(received);
+            return true;
+        }
+
+        if (!success && error == ERROR_MORE_DATA)
+            continue;
+
+        message.clear();
+        if (!m_shouldStop && error != ERROR_BROKEN_PIPE && error != ERROR_PIPE_NOT_CONNECTED)
+            std::cerr << "ReadFile failed: " << error << std::endl;
+        return false;
+    }
+}
+
+bool NamedPipeTransport::Write(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (!m_connected)
+        return false;
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = m_writeEvent;
+    DWORD bytesWritten = 0;
+    BOOL started = WriteFile(
+        m_hPipe,
+        message.c_str(),
+        static_cast<DWORD>(message.length()),
+        NULL,
+        &overlapped
+    );
+
+    if (!Complete(started, overlapped, bytesWritten))
+    {
+        DWORD error = GetLastError();
+        if (!m_shouldStop && error != ERROR_BROKEN_PIPE && error != ERROR_NO_DATA && error != ERROR_PIPE_NOT_CONNECTED)
+            std::cerr << "WriteFile failed: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
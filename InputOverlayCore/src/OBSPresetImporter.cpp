@@ -0,0 +1,191 @@
+#include "../include/OBSPresetImporter.h"
+#include "../include/KeyCodes.h"
+#include "../include/ConfigArena.h"
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+    // Gap between state frames in OBS texture sheets
+    const int STATE_SPACING = 3;
+
+    IntRect ReadMapping(const JSONValue& element)
+    {
+        int rect[4] = { 0, 0, 0, 0 };
+        element["mapping"].GetInts(rect, 4);
+        return IntRect(rect[0], rect[1], rect[2], rect[3]);
+    }
+
+    IntRect OffsetRect(const IntRect& rect, int dx, int dy)
+    {
+        return IntRect(rect.left + dx, rect.top + dy, rect.width, rect.height);
+    }
+
+    // OBS mouse button codes follow the same numbering as our presets:
+    // 1 left, 2 right, 3 middle, 4 X2, 5 X1 (see InputDetection::IsMouseButtonPressed)
+    int MouseButtonToVirtualKey(int button)
+    {
+        switch (button)
+        {
+        case 1: return VK_LBUTTON;
+        case 2: return VK_RBUTTON;
+        case 3: return VK_MBUTTON;
+        case 4: return VK_XBUTTON2;
+        case 5: return VK_XBUTTON1;
+        default: return 0;
+        }
+    }
+}
+
+namespace OBSPreset
+{
+    bool IsOBSPreset(const JSONValue& root)
+    {
+        if (!root.IsObject())
+            return false;
+
+        if (root.HasMember("overlay_width") || root.HasMember("default_width"))
+            return true;
+
+        // Headerless files: recognise by the element schema
+        for (JSONValue element : root["elements"])
+        {
+            return element["mapping"].IsArray() && element["type"].IsNumber();
+        }
+        return false;
+    }
+
+    int UiohookToVirtualKey(int code)
+    {
+        // libuiohook marks E0-prefixed keys as 0x0Exx; a few (arrows) already use 0xE0xx
+        if ((code & 0xFF00) == 0x0E00)
+            code = 0xE000 | (code & 0xFF);
+
+        return KeyCodes::ScancodeToVirtualKey(code);
+    }
+
+    bool Import(const JSONValue& root, OverlayConfig& config)
+    {
+        if (!IsOBSPreset(root))
+            return false;
+
+        config.version = 1;
+        config.canvasSize = Vector2i(root["overlay_width"].AsInt(0), root["overlay_height"].AsInt(0));
+        config.backgroundColor = Color::Transparent;
+
+        JSONValue elements = root["elements"];
+        config.elements.reserve(config.elements.size() + elements.Size());
+        ConfigArena& arena = ConfigArena::Of(config, elements.Size());
+
+        int unsupported = 0;
+        for (JSONValue source : elements)
+        {
+            if (!source.IsObject())
+                continue;
+
+            OverlayElement element;
+            element.id = arena.Intern(source["id"].AsStringView());
+            element.zOrder = source["z_level"].AsInt(0);
+
+            int position[2];
+            if (source["pos"].GetInts(position, 2) == 2)
+            {
+                element.position = Vector2i(position[0], position[1]);
+            }
+
+            IntRect mapping = ReadMapping(source);
+            element.sprite.normal = mapping;
+
+            int code = source["code"].AsInt(0);
+            switch (source["type"].AsInt(ELEMENT_TEXTURE))
+            {
+            case ELEMENT_TEXTURE:
+                break;
+
+            case ELEMENT_KEYBOARD_KEY:
+            {
+                int virtualKey = UiohookToVirtualKey(code);
+                if (virtualKey == 0)
+                {
+                    std::cerr << "OBS import: unknown key code 0x" << std::hex << code << std::dec
+                              << " for element '" << element.id << "'" << std::endl;
+                }
+
+                element.key.winvk = virtualKey;
+                element.key.hid = KeyCodes::VirtualKeyToHID(virtualKey);
+                element.key.evdev = KeyCodes::VirtualKeyToEvdev(virtualKey);
+                element.sprite.pressed = OffsetRect(mapping, 0, mapping.height + STATE_SPACING);
+                element.sprite.hasPressedState = true;
+                break;
+            }
+
+            case ELEMENT_MOUSE_BUTTON:
+                element.key.hid = code;
+                element.key.winvk = MouseButtonToVirtualKey(code);
+                element.key.evdev = KeyCodes::VirtualKeyToEvdev(element.key.winvk);
+                element.sprite.pressed = OffsetRect(mapping, 0, mapping.height + STATE_SPACING);
+                element.sprite.hasPressedState = true;
+                break;
+
+            case ELEMENT_MOUSE_WHEEL:
+            {
+                // Wheel click shows the pressed frame like the middle button
+                int step = mapping.width + STATE_SPACING;
+                element.isWheel = true;
+                element.key.hid = 3;
+                element.key.winvk = VK_MBUTTON;
+                element.key.evdev = KeyCodes::VirtualKeyToEvdev(VK_MBUTTON);
+                element.sprite.pressed = OffsetRect(mapping, step, 0);
+                element.sprite.up = OffsetRect(mapping, step * 2, 0);
+                element.sprite.down = OffsetRect(mapping, step * 3, 0);
+                element.sprite.hasPressedState = true;
+                element.sprite.hasUpState = true;
+                element.sprite.hasDownState = true;
+                break;
+            }
+
+            case ELEMENT_MOUSE_MOVEMENT:
+                element.cursor.enabled = true;
+                element.cursor.mode = source["mouse_type"].AsInt(0) == 1 ? "arrow" : "dot";
+                element.cursor.radius = source["mouse_radius"].AsInt(50);
+                break;
+
+            default:
+                // Gamepad, text etc. have no input source here; draw them statically
+                ++unsupported;
+                break;
+            }
+
+            element.sprite.ResolveStates(config.defaultPressedOffset);
+            config.elements.push_back(std::move(element));
+        }
+
+        if (unsupported > 0)
+        {
+            std::cout << "OBS import: " << unsupported << " gamepad/text element(s) imported as static textures" << std::endl;
+        }
+
+        return true;
+    }
+
+    std::string FindTextureFile(const std::string& presetPath)
+    {
+        std::filesystem::path path(presetPath);
+        std::error_code error;
+
+        std::filesystem::path own = path;
+        own.replace_extension(".png");
+        if (std::filesystem::exists(own, error))
+            return own.filename().string();
+
+        std::filesystem::path folder = path.parent_path();
+        if (!folder.empty())
+        {
+            std::filesystem::path shared = folder / (folder.filename().string() + ".png");
+            if (std::filesystem::exists(shared, error))
+                return shared.filename().string();
+        }
+
+        return "";
+    }
+}
\ No newline at end of file
@@ -61,7 +61,7 @@ std::unique_ptr<sf::RenderWindow> OverlayRenderer::CreateOverlayWindow(const Ove
     return window;
 }
 
-void OverlayRenderer::RenderOverlay(sf::RenderWindow& window, const OverlayConfig& config)
+void OverlayRenderer::RenderOverlay(int overlayId, sf::RenderWindow& window, const OverlayConfig& config)
 {
     if (!window.isOpen())
         return;
@@ -78,22 +78,115 @@ void OverlayRenderer::RenderOverlay(sf::RenderWindow& window, const OverlayConfi
         return;
     }
 
-    // Sort elements by z-order
-    auto sortedElements = config.elements;
-    std::sort(sortedElements.begin(), sortedElements.end(),
-        [](const OverlayElement& a, const OverlayElement& b) {
-            return a.zOrder < b.zOrder;
-        });
+    // First frame, new texture, or changes that were never reported: build everything
+    RenderCache& cache = m_renderCaches[overlayId];
+    if (cache.texture != texture || cache.sprites.size() != config.elements.size())
+    {
+        cache.texture = texture;
+        cache.sprites.resize(config.elements.size());
+        for (size_t i = 0; i < config.elements.size(); ++i)
+        {
+            BuildElementSprites(config.elements[i], *texture, cache.sprites[i]);
+        }
+        cache.orderDirty = true;
+    }
+
+    if (cache.orderDirty)
+    {
+        SortDrawOrder(config, cache);
+    }
 
     // Render all elements
-    for (const auto& element : sortedElements)
+    for (uint32_t index : cache.drawOrder)
     {
-        DrawElement(window, element, *texture);
+        const OverlayElement& element = config.elements[index];
+        const ElementSprites& sprites = cache.sprites[index];
+
+        // Every state has a sprite, missing ones were resolved at load
+        int state = element.isPressed ? SPRITE_PRESSED : element.wheelState;
+        window.draw(sprites.states[state]);
     }
 
     window.display();
 }
 
+void OverlayRenderer::ApplyChanges(int overlayId, const OverlayConfig& config, const std::vector<ConfigChange>& changes)
+{
+    auto it = m_renderCaches.find(overlayId);
+    if (it == m_renderCaches.end() || !it->second.texture)
+        return; // Nothing built yet, the first frame builds it
+
+    RenderCache& cache = it->second;
+
+    // Replay the edits on the sprite list so indices line up with the final
+    // config, then rebuild only the entries that were updated or added
+    std::vector<bool> stale(cache.sprites.size(), false);
+    for (const ConfigChange& change : changes)
+    {
+        if (change.index > cache.sprites.size())
+            break;
+
+        switch (change.kind)
+        {
+        case ConfigChange::Kind::Update:
+            if (change.index < stale.size())
+                stale[change.index] = true;
+            break;
+        case ConfigChange::Kind::Add:
+            cache.sprites.insert(cache.sprites.begin() + change.index, ElementSprites());
+            stale.insert(stale.begin() + change.index, true);
+            break;
+        case ConfigChange::Kind::Remove:
+            if (change.index < stale.size())
+            {
+                cache.sprites.erase(cache.sprites.begin() + change.index);
+                stale.erase(stale.begin() + change.index);
+            }
+            break;
+        }
+    }
+
+    if (cache.sprites.size() != config.elements.size())
+    {
+        // Out of step with the config; rebuild on the next frame
+        m_renderCaches.erase(it);
+        return;
+    }
+
+    for (size_t i = 0; i < stale.size(); ++i)
+    {
+        if (stale[i])
+        {
+            BuildElementSprites(config.elements[i], *cache.texture, cache.sprites[i]);
+        }
+    }
+
+    // An update may have moved an element in z; re-sorting indices is cheap
+    cache.orderDirty = !changes.empty();
+}
+
+void OverlayRenderer::RemoveOverlay(int overlayId)
+{
+    m_renderCaches.erase(overlayId);
+}
+
+void OverlayRenderer::SortDrawOrder(const OverlayConfig& config, RenderCache& cache)
+{
+    cache.drawOrder.resize(config.elements.size());
+    for (size_t i = 0; i < cache.drawOrder.size(); ++i)
+    {
+        cache.drawOrder[i] = static_cast<uint32_t>(i);
+    }
+
+    // Stable, so equal z keeps document order
+    std::stable_sort(cache.drawOrder.begin(), cache.drawOrder.end(),
+        [&config](uint32_t a, uint32_t b) {
+            return config.elements[a].zOrder < config.elements[b].zOrder;
+        });
+
+    cache.orderDirty = false;
+}
+
 bool OverlayRenderer::LoadTexture(const std::string& filePath)
 {
     if (m_textures.find(filePath) != m_textures.end())
@@ -113,27 +206,43 @@ bool OverlayRenderer::LoadTexture(const std::string& filePath)
     return true;
 }
 
+bool OverlayRenderer::ReloadTexture(const std::string& filePath)
+{
+    auto it = m_textures.find(filePath);
+    if (it == m_textures.end())
+        return LoadTexture(filePath);
+
+    // Load into the existing object: sprites point at it, and a failed load
+    // (file still being written) leaves the old image in place
+    sf::Texture texture;
+    if (!texture.loadFromFile(filePath))
+    {
+        std::cerr << "Failed to reload texture: " << filePath << std::endl;
+        return false;
+    }
+
+    it->second = std::move(texture);
+    std::cout << "Reloaded texture: " << filePath << std::endl;
+    return true;
+}
+
 sf::Texture* OverlayRenderer::GetTexture(const std::string& filePath)
 {
     auto it = m_textures.find(filePath);
     return (it != m_textures.end()) ? &it->second : nullptr;
 }
 
-void OverlayRenderer::DrawElement(sf::RenderWindow& window, const OverlayElement& element, const sf::Texture& texture)
+void OverlayRenderer::BuildElementSprites(const OverlayElement& element, const sf::Texture& texture, ElementSprites& sprites)
 {
-    sf::Sprite sprite(texture);
+    sf::Vector2f position(static_cast<float>(element.position.x), static_cast<float>(element.position.y));
 
-    // Choose sprite rect based on pressed state
-    sf::IntRect rect = element.sprite.normal;
-    if (element.isPressed && element.sprite.hasPressedState)
+    for (int state = 0; state < SPRITE_STATE_COUNT; ++state)
     {
-        rect = element.sprite.pressed;
+        const IntRect& rect = element.sprite.states[state];
+        sprites.states[state].setTexture(texture);
+        sprites.states[state].setTextureRect(sf::IntRect(rect.left, rect.top, rect.width, rect.height));
+        sprites.states[state].setPosition(position);
     }
-
-    sprite.setTextureRect(rect);
-    sprite.setPosition(static_cast<float>(element.position.x), static_cast<float>(element.position.y));
-
-    window.draw(sprite);
 }
 
 void OverlayRenderer::SetWindowProperties(sf::RenderWindow& window, bool noBorders, bool topMost)
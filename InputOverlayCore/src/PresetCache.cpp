@@ -0,0 +1,342 @@
+#include "../include/PresetCache.h"
+#include "../include/ConfigArena.h"
+#include "../include/MappedFile.h"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    struct StringRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct CacheHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t headerSize;
+        uint64_t contentHash;
+        uint32_t fileSize;
+        uint32_t elementCount;
+        uint32_t elementsOffset;
+        uint32_t elementSize;
+
+        int32_t configVersion;
+        StringRef textureFile;
+        int32_t textureSize[2];
+        int32_t canvasSize[2];
+        uint8_t backgroundColor[4];
+        int32_t defaultPressedOffset[2];
+        uint32_t latchTaps;
+        int32_t minPressDurationMs;
+    };
+
+    // CacheElement::flags
+    const uint32_t ELEMENT_HAS_PRESSED = 1 << 0;
+    const uint32_t ELEMENT_HAS_UP = 1 << 1;
+    const uint32_t ELEMENT_HAS_DOWN = 1 << 2;
+    const uint32_t ELEMENT_WHEEL = 1 << 3;
+    const uint32_t ELEMENT_CURSOR = 1 << 4;
+
+    struct CacheElement
+    {
+        StringRef id;
+        StringRef keyId;
+        int32_t hid;
+        int32_t winvk;
+        int32_t evdev;
+        int32_t position[2];
+        int32_t normal[4];
+        int32_t pressed[4];
+        int32_t up[4];
+        int32_t down[4];
+        int32_t zOrder;
+        uint32_t flags;
+        int32_t cursorRadius;
+        StringRef cursorMode;
+    };
+
+    static_assert(sizeof(CacheHeader) == 80, "CacheHeader layout is part of the file format");
+    static_assert(sizeof(CacheElement) == 120, "CacheElement layout is part of the file format");
+
+    void WriteRect(const IntRect& rect, int32_t* out)
+    {
+        out[0] = rect.left;
+        out[1] = rect.top;
+        out[2] = rect.width;
+        out[3] = rect.height;
+    }
+
+    IntRect ReadRect(const int32_t* in)
+    {
+        return IntRect(in[0], in[1], in[2], in[3]);
+    }
+
+    // Collects strings behind the element table while serializing
+    class StringWriter
+    {
+    public:
+        explicit StringWriter(std::vector<uint8_t>& strings) : m_strings(strings) {}
+
+        StringRef Add(std::string_view text)
+        {
+            StringRef ref;
+            ref.offset = static_cast<uint32_t>(m_strings.size());
+            ref.length = static_cast<uint32_t>(text.size());
+            m_strings.insert(m_strings.end(), text.begin(), text.end());
+            return ref;
+        }
+
+    private:
+        std::vector<uint8_t>& m_strings;
+    };
+
+    bool ReadString(const uint8_t* data, size_t size, const StringRef& ref, std::string& out)
+    {
+        if (ref.offset > size || ref.length > size - ref.offset)
+            return false;
+
+        out.assign(reinterpret_cast<const char*>(data) + ref.offset, ref.length);
+        return true;
+    }
+
+    bool ReadString(const uint8_t* data, size_t size, const StringRef& ref, ConfigArena& arena, std::string_view& out)
+    {
+        if (ref.offset > size || ref.length > size - ref.offset)
+            return false;
+
+        out = arena.Intern(std::string_view(reinterpret_cast<const char*>(data) + ref.offset, ref.length));
+        return true;
+    }
+}
+
+namespace PresetCache
+{
+    uint64_t HashText(std::string_view text)
+    {
+        // FNV-1a over 8-byte words, then the tail bytewise: one multiply per
+        // word keeps hashing well under the cost of reading the cache
+        const uint64_t prime = 1099511628211ULL;
+        uint64_t hash = 14695981039346656037ULL;
+
+        const char* data = text.data();
+        size_t size = text.size();
+        size_t words = size / sizeof(uint64_t);
+        for (size_t i = 0; i < words; ++i)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+            hash ^= word;
+            hash *= prime;
+        }
+
+        for (size_t i = words * sizeof(uint64_t); i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= prime;
+        }
+
+        return hash;
+    }
+
+    void Serialize(const OverlayConfig& config, uint64_t contentHash, std::vector<uint8_t>& out)
+    {
+        size_t base = out.size();
+        size_t elementsOffset = sizeof(CacheHeader);
+        size_t stringsOffset = elementsOffset + config.elements.size() * sizeof(CacheElement);
+
+        std::vector<uint8_t> strings;
+        StringWriter writer(strings);
+
+        CacheHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.headerSize = sizeof(CacheHeader);
+        header.contentHash = contentHash;
+        header.elementCount = static_cast<uint32_t>(config.elements.size());
+        header.elementsOffset = static_cast<uint32_t>(elementsOffset);
+        header.elementSize = sizeof(CacheElement);
+        header.configVersion = config.version;
+        header.textureFile = writer.Add(config.textureFile);
+        header.textureSize[0] = config.textureSize.x;
+        header.textureSize[1] = config.textureSize.y;
+        header.canvasSize[0] = config.canvasSize.x;
+        header.canvasSize[1] = config.canvasSize.y;
+        header.backgroundColor[0] = config.backgroundColor.r;
+        header.backgroundColor[1] = config.backgroundColor.g;
+        header.backgroundColor[2] = config.backgroundColor.b;
+        header.backgroundColor[3] = config.backgroundColor.a;
+        header.defaultPressedOffset[0] = config.defaultPressedOffset.x;
+        header.defaultPressedOffset[1] = config.defaultPressedOffset.y;
+        header.latchTaps = config.latchTaps ? 1 : 0;
+        header.minPressDurationMs = config.minPressDurationMs;
+
+        std::vector<CacheElement> elements(config.elements.size());
+        for (size_t i = 0; i < config.elements.size(); ++i)
+        {
+            const OverlayElement& source = config.elements[i];
+            CacheElement& element = elements[i];
+            element = CacheElement();
+
+            element.id = writer.Add(source.id);
+            element.keyId = writer.Add(source.key.id);
+            element.hid = source.key.hid;
+            element.winvk = source.key.winvk;
+            element.evdev = source.key.evdev;
+            element.position[0] = source.position.x;
+            element.position[1] = source.position.y;
+            WriteRect(source.sprite.normal, element.normal);
+            WriteRect(source.sprite.pressed, element.pressed);
+            WriteRect(source.sprite.up, element.up);
+            WriteRect(source.sprite.down, element.down);
+            element.zOrder = source.zOrder;
+            element.flags = (source.sprite.hasPressedState ? ELEMENT_HAS_PRESSED : 0u) |
+                            (source.sprite.hasUpState ? ELEMENT_HAS_UP : 0u) |
+                            (source.sprite.hasDownState ? ELEMENT_HAS_DOWN : 0u) |
+                            (source.isWheel ? ELEMENT_WHEEL : 0u) |
+                            (source.cursor.enabled ? ELEMENT_CURSOR : 0u);
+            element.cursorRadius = source.cursor.radius;
+            element.cursorMode = writer.Add(source.cursor.mode);
+        }
+
+        // String offsets were collected relative to the string block
+        auto rebase = [stringsOffset](StringRef& ref) { ref.offset += static_cast<uint32_t>(stringsOffset); };
+        rebase(header.textureFile);
+        for (auto& element : elements)
+        {
+            rebase(element.id);
+            rebase(element.keyId);
+            rebase(element.cursorMode);
+        }
+
+        header.fileSize = static_cast<uint32_t>(stringsOffset + strings.size());
+
+        out.resize(base + header.fileSize);
+        uint8_t* image = out.data() + base;
+        std::memcpy(image, &header, sizeof(header));
+        if (!elements.empty())
+            std::memcpy(image + elementsOffset, elements.data(), elements.size() * sizeof(CacheElement));
+        if (!strings.empty())
+            std::memcpy(image + stringsOffset, strings.data(), strings.size());
+    }
+
+    bool Deserialize(const uint8_t* data, size_t size, uint64_t expectedHash, OverlayConfig& config)
+    {
+        if (size < sizeof(CacheHeader))
+            return false;
+
+        // The mapping may be unaligned for our structs; copy records out
+        CacheHeader header;
+        std::memcpy(&header, data, sizeof(header));
+
+        if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != VERSION ||
+            header.headerSize != sizeof(CacheHeader) ||
+            header.elementSize != sizeof(CacheElement) ||
+            header.contentHash != expectedHash ||
+            header.fileSize != size)
+        {
+            return false;
+        }
+
+        uint64_t elementsEnd = static_cast<uint64_t>(header.elementsOffset) +
+                               static_cast<uint64_t>(header.elementCount) * sizeof(CacheElement);
+        if (header.elementsOffset < sizeof(CacheHeader) || elementsEnd > size)
+            return false;
+
+        OverlayConfig result;
+        result.version = header.configVersion;
+        if (!ReadString(data, size, header.textureFile, result.textureFile))
+            return false;
+        result.textureSize = Vector2i(header.textureSize[0], header.textureSize[1]);
+        result.canvasSize = Vector2i(header.canvasSize[0], header.canvasSize[1]);
+        result.backgroundColor = Color(header.backgroundColor[0], header.backgroundColor[1],
+                                       header.backgroundColor[2], header.backgroundColor[3]);
+        result.defaultPressedOffset = Vector2i(header.defaultPressedOffset[0], header.defaultPressedOffset[1]);
+        result.latchTaps = header.latchTaps != 0;
+        result.minPressDurationMs = header.minPressDurationMs;
+
+        ConfigArena& arena = ConfigArena::Of(result, header.elementCount);
+
+        result.elements.resize(header.elementCount);
+        const uint8_t* records = data + header.elementsOffset;
+        for (uint32_t i = 0; i < header.elementCount; ++i)
+        {
+            CacheElement element;
+            std::memcpy(&element, records + i * sizeof(CacheElement), sizeof(element));
+
+            OverlayElement& target = result.elements[i];
+            if (!ReadString(data, size, element.id, arena, target.id) ||
+                !ReadString(data, size, element.keyId, arena, target.key.id) ||
+                !ReadString(data, size, element.cursorMode, arena, target.cursor.mode))
+            {
+                return false;
+            }
+
+            target.key.hid = element.hid;
+            target.key.winvk = element.winvk;
+            target.key.evdev = element.evdev;
+            target.position = Vector2i(element.position[0], element.position[1]);
+            target.sprite.normal = ReadRect(element.normal);
+            target.sprite.pressed = ReadRect(element.pressed);
+            target.sprite.up = ReadRect(element.up);
+            target.sprite.down = ReadRect(element.down);
+            target.sprite.hasPressedState = (element.flags & ELEMENT_HAS_PRESSED) != 0;
+            target.sprite.hasUpState = (element.flags & ELEMENT_HAS_UP) != 0;
+            target.sprite.hasDownState = (element.flags & ELEMENT_HAS_DOWN) != 0;
+            target.sprite.ResolveStates(result.defaultPressedOffset);
+            target.zOrder = element.zOrder;
+            target.isWheel = (element.flags & ELEMENT_WHEEL) != 0;
+            target.cursor.enabled = (element.flags & ELEMENT_CURSOR) != 0;
+            target.cursor.radius = element.cursorRadius;
+        }
+
+        config = std::move(result);
+        return true;
+    }
+
+    bool Load(const std::string& cachePath, uint64_t expectedHash, OverlayConfig& config)
+    {
+        MappedFile file;
+        if (!file.Open(cachePath))
+            return false;
+
+        return Deserialize(file.Data(), file.Size(), expectedHash, config);
+    }
+
+    bool Save(const std::string& cachePath, uint64_t contentHash, const OverlayConfig& config)
+    {
+        std::vector<uint8_t> image;
+        Serialize(config, contentHash, image);
+
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+            if (!file.good())
+            {
+                file.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+#ifdef _WIN32
+        if (!MoveFileExA(tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+#else
+        if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+#endif
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
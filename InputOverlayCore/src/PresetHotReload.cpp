@@ -0,0 +1,291 @@
+#include "../include/PresetHotReload.h"
+#include "../include/ConfigArena.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <set>
+
+bool PresetHotReload::Initialize()
+{
+    if (!m_watcher.Initialize())
+    {
+        std::cerr << "Preset hot reload is not available on this platform" << std::endl;
+        return false;
+    }
+
+    // Someone is editing these presets; point at mistakes instead of loading around them
+    m_parser.SetStrictValidation(true);
+    return true;
+}
+
+void PresetHotReload::Shutdown()
+{
+    m_tracked.clear();
+    m_watcher.Shutdown();
+}
+
+std::string PresetHotReload::ResolveTexturePath(const std::string& presetPath, const std::string& textureFile)
+{
+    if (textureFile.empty())
+        return "";
+
+    std::error_code error;
+    std::filesystem::path besidePreset = std::filesystem::path(presetPath).parent_path() / textureFile;
+    if (std::filesystem::exists(besidePreset, error))
+        return besidePreset.string();
+
+    return textureFile;
+}
+
+void PresetHotReload::Track(int overlayId, const std::string& presetPath, const OverlayConfig& config,
+                            const std::vector<std::string>& dependencies)
+{
+    Untrack(overlayId);
+
+    TrackedPreset tracked;
+    tracked.presetPath = presetPath;
+    tracked.texturePath = ResolveTexturePath(presetPath, config.textureFile);
+
+    m_watcher.Watch(tracked.presetPath);
+    if (!tracked.texturePath.empty())
+    {
+        m_watcher.Watch(tracked.texturePath);
+    }
+    SetDependencies(tracked, dependencies);
+
+    m_tracked[overlayId] = std::move(tracked);
+}
+
+void PresetHotReload::SetDependencies(TrackedPreset& tracked, const std::vector<std::string>& dependencies)
+{
+    // Watch the new set before dropping the old one, so shared files stay watched
+    for (const std::string& path : dependencies)
+    {
+        m_watcher.Watch(path);
+    }
+    for (const std::string& path : tracked.dependencies)
+    {
+        m_watcher.Unwatch(path);
+    }
+    tracked.dependencies = dependencies;
+}
+
+void PresetHotReload::Untrack(int overlayId)
+{
+    auto it = m_tracked.find(overlayId);
+    if (it == m_tracked.end())
+        return;
+
+    m_watcher.Unwatch(it->second.presetPath);
+    if (!it->second.texturePath.empty())
+    {
+        m_watcher.Unwatch(it->second.texturePath);
+    }
+    SetDependencies(it->second, {});
+    m_tracked.erase(it);
+}
+
+void PresetHotReload::Poll(std::map<int, OverlayConfig>& configs, std::vector<PresetReload>& reloads)
+{
+    std::vector<FileChange> files;
+    m_watcher.Poll(files);
+    if (files.empty())
+        return;
+
+    for (auto& [overlayId, tracked] : m_tracked)
+    {
+        auto configIt = configs.find(overlayId);
+        if (configIt == configs.end())
+            continue;
+
+        PresetReload reload;
+        reload.overlayId = overlayId;
+        bool presetChanged = false;
+
+        for (const FileChange& file : files)
+        {
+            // Changes are reported under canonical paths, whatever spelling was tracked
+            auto isChanged = [&file](const std::string& path) { return FileWatcher::CanonicalPath(path) == file.path; };
+
+            if (isChanged(tracked.presetPath))
+            {
+                presetChanged = true;
+                reload.detectedNs = file.detectedNs;
+            }
+            else if (std::any_of(tracked.dependencies.begin(), tracked.dependencies.end(), isChanged))
+            {
+                presetChanged = true;
+                if (reload.detectedNs == 0)
+                    reload.detectedNs = file.detectedNs;
+            }
+            else if (!tracked.texturePath.empty() && isChanged(tracked.texturePath))
+            {
+                reload.textureChanged = true;
+                if (reload.detectedNs == 0)
+                    reload.detectedNs = file.detectedNs;
+            }
+        }
+
+        if (presetChanged)
+        {
+            auto start = std::chrono::steady_clock::now();
+            OverlayConfig updated;
+            if (!m_parser.ParseConfigFromFile(tracked.presetPath, updated))
+            {
+                std::cerr << "Keeping the previous version of " << tracked.presetPath << std::endl;
+                presetChanged = false;
+            }
+            else
+            {
+                reload.parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                SetDependencies(tracked, m_parser.GetDependencies());
+
+                OverlayConfig& live = configIt->second;
+                if (updated.textureFile != live.textureFile)
+                {
+                    // Follow the preset to its new texture
+                    if (!tracked.texturePath.empty())
+                        m_watcher.Unwatch(tracked.texturePath);
+
+                    tracked.texturePath = ResolveTexturePath(tracked.presetPath, updated.textureFile);
+                    if (!tracked.texturePath.empty())
+                        m_watcher.Watch(tracked.texturePath);
+
+                    reload.textureChanged = true;
+                }
+
+                reload.replaced = !ApplyDiff(live, std::move(updated), reload.changes);
+            }
+        }
+
+        if (presetChanged || reload.textureChanged)
+        {
+            reloads.push_back(std::move(reload));
+        }
+    }
+}
+
+bool PresetHotReload::ElementsEqual(const OverlayElement& a, const OverlayElement& b)
+{
+    const SpriteInfo& sa = a.sprite;
+    const SpriteInfo& sb = b.sprite;
+
+    return a.id == b.id &&
+        a.key.hid == b.key.hid && a.key.winvk == b.key.winvk && a.key.evdev == b.key.evdev &&
+        a.position == b.position &&
+        std::equal(std::begin(sa.states), std::end(sa.states), std::begin(sb.states)) &&
+        sa.hasPressedState == sb.hasPressedState && sa.hasUpState == sb.hasUpState && sa.hasDownState == sb.hasDownState &&
+        a.zOrder == b.zOrder &&
+        a.isWheel == b.isWheel &&
+        a.cursor.enabled == b.cursor.enabled && a.cursor.mode == b.cursor.mode && a.cursor.radius == b.cursor.radius;
+}
+
+bool PresetHotReload::HasUniqueIds(const std::vector<OverlayElement>& elements)
+{
+    std::set<std::string_view> ids;
+    for (const auto& element : elements)
+    {
+        if (element.id.empty() || !ids.insert(element.id).second)
+            return false;
+    }
+    return true;
+}
+
+bool PresetHotReload::ApplyDiff(OverlayConfig& live, OverlayConfig&& updated, std::vector<ConfigChange>& changes)
+{
+    std::vector<OverlayElement>& current = live.elements;
+    std::vector<OverlayElement>& target = updated.elements;
+
+    bool matched = true;
+    if (HasUniqueIds(current) && HasUniqueIds(target))
+    {
+        std::map<std::string_view, size_t> targetIndex;
+        for (size_t i = 0; i < target.size(); ++i)
+        {
+            targetIndex[target[i].id] = i;
+        }
+
+        // Elements the new version dropped, back to front so indices stay valid
+        for (size_t i = current.size(); i-- > 0; )
+        {
+            if (targetIndex.find(current[i].id) == targetIndex.end())
+            {
+                current.erase(current.begin() + i);
+                live.keyStateIndices.erase(live.keyStateIndices.begin() + i);
+                changes.push_back({ ConfigChange::Kind::Remove, i });
+            }
+        }
+
+        // The survivors must still be in document order to be patched in place
+        size_t previous = 0;
+        for (size_t i = 0; i < current.size() && matched; ++i)
+        {
+            size_t index = targetIndex[current[i].id];
+            matched = (i == 0 || index > previous);
+            previous = index;
+        }
+    }
+    else
+    {
+        matched = current.size() == target.size();
+        if (matched)
+        {
+            // Without ids the best match is position in the file
+            for (size_t i = 0; i < current.size(); ++i)
+            {
+                current[i].id = target[i].id;
+            }
+        }
+    }
+
+    if (!matched)
+    {
+        changes.clear();
+        live = std::move(updated);
+        return false;
+    }
+
+    // Walk the new version: equal elements stay, changed ones are replaced,
+    // and any id not yet in place is an insertion
+    for (size_t i = 0; i < target.size(); ++i)
+    {
+        if (i < current.size() && current[i].id == target[i].id)
+        {
+            if (!ElementsEqual(current[i], target[i]))
+            {
+                bool isPressed = current[i].isPressed;
+                current[i] = std::move(target[i]);
+                current[i].isPressed = isPressed;
+                live.keyStateIndices[i] = current[i].key.stateIndex;
+                changes.push_back({ ConfigChange::Kind::Update, i });
+            }
+        }
+        else
+        {
+            live.keyStateIndices.insert(live.keyStateIndices.begin() + i, target[i].key.stateIndex);
+            current.insert(current.begin() + i, std::move(target[i]));
+            changes.push_back({ ConfigChange::Kind::Add, i });
+        }
+    }
+
+    // Everything outside the element list is cheap to take over as is
+    updated.elements.clear();
+    updated.keyStateIndices.clear();
+    std::vector<OverlayElement> elements = std::move(live.elements);
+    std::vector<uint8_t> keyStateIndices = std::move(live.keyStateIndices);
+    std::shared_ptr<ConfigArena> previousArena = live.arena;
+    live = std::move(updated);
+    live.elements = std::move(elements);
+    live.keyStateIndices = std::move(keyStateIndices);
+
+    // Survivors still point into the old arena. The new one already holds
+    // their strings (ids matched), so this is lookups, and the old text is
+    // released in one step instead of piling up across reloads.
+    ConfigArena& arena = ConfigArena::Of(live);
+    for (auto& element : live.elements)
+    {
+        arena.Adopt(element);
+    }
+    previousArena.reset();
+    return true;
+}
\ No newline at end of file
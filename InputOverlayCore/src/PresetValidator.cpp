@@ -0,0 +1,633 @@
+#include "../include/PresetValidator.h"
+#include "../include/MappedFile.h"
+#include "../include/OBSPresetImporter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    const char* TypeName(JSONType type)
+    {
+        switch (type)
+        {
+        case JSONType::Null: return "null";
+        case JSONType::Bool: return "a boolean";
+        case JSONType::Number: return "a number";
+        case JSONType::String: return "a string";
+        case JSONType::Array: return "an array";
+        case JSONType::Object: return "an object";
+        default: return "nothing";
+        }
+    }
+
+    // Width and height from the IHDR chunk, which PNG requires to come first
+    bool ReadPNGSize(const std::string& path, Vector2i& size)
+    {
+        static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+        unsigned char header[24];
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            return false;
+
+        if (std::memcmp(header, SIGNATURE, sizeof(SIGNATURE)) != 0 || std::memcmp(header + 12, "IHDR", 4) != 0)
+            return false;
+
+        auto readBigEndian = [](const unsigned char* p)
+        {
+            return static_cast<int>((static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+        };
+        size = Vector2i(readBigEndian(header + 16), readBigEndian(header + 20));
+        return size.x > 0 && size.y > 0;
+    }
+
+    std::string RectText(const IntRect& rect)
+    {
+        return "[" + std::to_string(rect.left) + ", " + std::to_string(rect.top) + ", " +
+               std::to_string(rect.width) + ", " + std::to_string(rect.height) + "]";
+    }
+
+    std::string SizeText(const Vector2i& size)
+    {
+        return std::to_string(size.x) + "x" + std::to_string(size.y);
+    }
+
+    // One validation pass over a parsed document
+    class Checker
+    {
+    public:
+        Checker(const JSONDocument& document, std::vector<PresetIssue>& issues)
+            : m_document(document), m_issues(issues) {}
+
+        bool HasErrors() const { return m_errors > 0; }
+
+        void Check(const std::string& presetPath)
+        {
+            JSONValue root = m_document.Root();
+            if (!root.IsObject())
+            {
+                Error(root, std::string("a preset must be an object, found ") + TypeName(root.GetType()));
+            }
+            else if (OBSPreset::IsOBSPreset(root))
+            {
+                CheckOBS(root, presetPath);
+            }
+            else
+            {
+                CheckNative(root, presetPath);
+            }
+        }
+
+    private:
+        const JSONDocument& m_document;
+        std::vector<PresetIssue>& m_issues;
+        size_t m_errors = 0;
+
+        Vector2i m_textureSize;   // 0x0 when unknown
+        Vector2i m_canvasSize;
+        Vector2i m_pressedOffset;
+        bool m_composed = false;  // Extends or includes; elements may override inherited ones
+
+        void Report(PresetIssue::Severity severity, const JSONValue& at, const std::string& message)
+        {
+            PresetIssue issue;
+            issue.severity = severity;
+            m_document.GetLineColumn(at.GetOffset(), issue.line, issue.column);
+            issue.message = message;
+            m_issues.push_back(std::move(issue));
+
+            if (severity == PresetIssue::Severity::Error)
+                ++m_errors;
+        }
+
+        void Error(const JSONValue& at, const std::string& message) { Report(PresetIssue::Severity::Error, at, message); }
+        void Warning(const JSONValue& at, const std::string& message) { Report(PresetIssue::Severity::Warning, at, message); }
+
+        // False if the value is missing (not an issue) or has another type (reported)
+        bool Expect(const JSONValue& value, JSONType type, const std::string& name)
+        {
+            if (!value.IsValid())
+                return false;
+
+            if (value.GetType() != type)
+            {
+                Error(value, name + " must be " + TypeName(type) + ", found " + TypeName(value.GetType()));
+                return false;
+            }
+            return true;
+        }
+
+        bool ExpectInt(const JSONValue& value, const std::string& name, int minimum, int& out)
+        {
+            if (!Expect(value, JSONType::Number, name))
+                return false;
+
+            if (!value.FitsInt())
+            {
+                Error(value, name + " is out of range");
+                return false;
+            }
+
+            if (!value.IsInteger())
+            {
+                Error(value, name + " must be an integer");
+                return false;
+            }
+
+            out = value.AsInt();
+            if (out < minimum)
+            {
+                Error(value, name + " must be at least " + std::to_string(minimum));
+                return false;
+            }
+            return true;
+        }
+
+        // An array of exactly 'count' integers
+        bool ExpectInts(const JSONValue& value, const std::string& name, int* out, size_t count)
+        {
+            if (!Expect(value, JSONType::Array, name))
+                return false;
+
+            if (value.Size() != count)
+            {
+                Error(value, name + " must have " + std::to_string(count) + " integers, found " + std::to_string(value.Size()));
+                return false;
+            }
+
+            size_t index = 0;
+            for (JSONValue item : value)
+            {
+                if (item.IsNumber() && !item.FitsInt())
+                {
+                    Error(item, name + "[" + std::to_string(index) + "] is out of range");
+                    return false;
+                }
+
+                if (!item.IsInteger())
+                {
+                    Error(item, name + "[" + std::to_string(index) + "] must be an integer, found " +
+                                (item.IsNumber() ? "a fraction" : TypeName(item.GetType())));
+                    return false;
+                }
+                out[index++] = item.AsInt();
+            }
+            return true;
+        }
+
+        // Unknown members are usually typos that the parser silently ignores
+        void CheckMembers(const JSONValue& object, std::initializer_list<std::string_view> known, const std::string& where)
+        {
+            for (auto it = object.begin(); it != object.end(); ++it)
+            {
+                std::string_view key = it.Key();
+                if (std::find(known.begin(), known.end(), key) == known.end())
+                {
+                    Warning(*it, "unknown member \"" + std::string(key) + "\" in " + where + " is ignored");
+                }
+            }
+        }
+
+        void CheckNative(const JSONValue& root, const std::string& presetPath)
+        {
+            CheckMembers(root, { "version", "extends", "include", "texture", "canvas", "defaults", "elements" }, "the preset");
+            CheckParts(root, presetPath);
+
+            int version = 0;
+            ExpectInt(root["version"], "version", 1, version);
+
+            std::string textureFile;
+            JSONValue texture = root["texture"];
+            if (Expect(texture, JSONType::Object, "texture"))
+            {
+                CheckMembers(texture, { "file", "size" }, "texture");
+
+                if (Expect(texture["file"], JSONType::String, "texture.file"))
+                    textureFile = texture["file"].AsString();
+
+                int size[2];
+                if (ExpectInts(texture["size"], "texture.size", size, 2))
+                {
+                    if (size[0] <= 0 || size[1] <= 0)
+                        Error(texture["size"], "texture.size must be positive");
+                    else
+                        m_textureSize = Vector2i(size[0], size[1]);
+                }
+            }
+
+            // Textures are named relative to the preset, or the working directory
+            if (m_textureSize.x == 0 && !textureFile.empty())
+            {
+                std::filesystem::path besidePreset = std::filesystem::path(presetPath).parent_path() / textureFile;
+                if (!ReadPNGSize(besidePreset.string(), m_textureSize))
+                    ReadPNGSize(textureFile, m_textureSize);
+            }
+
+            JSONValue canvas = root["canvas"];
+            if (Expect(canvas, JSONType::Object, "canvas"))
+            {
+                CheckMembers(canvas, { "size", "background" }, "canvas");
+
+                int size[2];
+                if (ExpectInts(canvas["size"], "canvas.size", size, 2))
+                {
+                    if (size[0] <= 0 || size[1] <= 0)
+                        Error(canvas["size"], "canvas.size must be positive");
+                    else
+                        m_canvasSize = Vector2i(size[0], size[1]);
+                }
+
+                int background[4];
+                if (ExpectInts(canvas["background"], "canvas.background", background, 4))
+                {
+                    for (int channel : background)
+                    {
+                        if (channel < 0 || channel > 255)
+                        {
+                            Error(canvas["background"], "canvas.background channels must be 0-255");
+                            break;
+                        }
+                    }
+                }
+            }
+
+            JSONValue defaults = root["defaults"];
+            if (Expect(defaults, JSONType::Object, "defaults"))
+            {
+                CheckMembers(defaults, { "pressed_offset", "latch_taps", "min_press_ms" }, "defaults");
+
+                int offset[2];
+                if (ExpectInts(defaults["pressed_offset"], "defaults.pressed_offset", offset, 2))
+                    m_pressedOffset = Vector2i(offset[0], offset[1]);
+
+                Expect(defaults["latch_taps"], JSONType::Bool, "defaults.latch_taps");
+
+                int minPress = 0;
+                ExpectInt(defaults["min_press_ms"], "defaults.min_press_ms", 0, minPress);
+            }
+
+            JSONValue elements = root["elements"];
+            if (!elements.IsValid())
+            {
+                if (!m_composed)
+                    Warning(root, "the preset has no elements");
+            }
+            else if (Expect(elements, JSONType::Array, "elements"))
+            {
+                std::map<std::string_view, JSONValue> ids;
+                size_t index = 0;
+                for (JSONValue element : elements)
+                {
+                    CheckElement(element, index++, ids);
+                }
+            }
+        }
+
+        // "extends": "file" and "include": "file" or ["file", ...], relative to the preset
+        void CheckParts(const JSONValue& root, const std::string& presetPath)
+        {
+            std::vector<JSONValue> files;
+
+            JSONValue extends = root["extends"];
+            if (Expect(extends, JSONType::String, "extends"))
+                files.push_back(extends);
+
+            JSONValue include = root["include"];
+            if (include.IsString())
+            {
+                files.push_back(include);
+            }
+            else if (include.IsArray())
+            {
+                size_t index = 0;
+                for (JSONValue file : include)
+                {
+                    if (Expect(file, JSONType::String, "include[" + std::to_string(index++) + "]"))
+                        files.push_back(file);
+                }
+            }
+            else if (include.IsValid())
+            {
+                Error(include, std::string("include must be a string or an array, found ") + TypeName(include.GetType()));
+            }
+
+            m_composed = extends.IsValid() || include.IsValid();
+
+            std::filesystem::path directory = std::filesystem::path(presetPath).parent_path();
+            for (const JSONValue& file : files)
+            {
+                std::error_code error;
+                std::filesystem::path part = (directory / std::string(file.AsStringView())).lexically_normal();
+                if (!std::filesystem::is_regular_file(part, error))
+                    Error(file, "cannot find " + part.string());
+            }
+        }
+
+        void CheckElement(const JSONValue& elementJson, size_t index, std::map<std::string_view, JSONValue>& ids)
+        {
+            std::string name = "elements[" + std::to_string(index) + "]";
+            if (!Expect(elementJson, JSONType::Object, name))
+                return;
+
+            CheckMembers(elementJson, { "id", "codes", "pos", "sprite", "z", "wheel", "cursor", "remove" }, name);
+            Expect(elementJson["remove"], JSONType::Bool, name + ".remove");
+
+            JSONValue id = elementJson["id"];
+            if (Expect(id, JSONType::String, name + ".id"))
+            {
+                auto [previous, added] = ids.emplace(id.AsStringView(), id);
+                if (!added)
+                {
+                    int line = 0;
+                    int column = 0;
+                    m_document.GetLineColumn(previous->second.GetOffset(), line, column);
+                    Warning(id, "duplicate id \"" + std::string(id.AsStringView()) + "\" (first at line " +
+                                std::to_string(line) + "); hot reload matches these elements by position");
+                }
+                name += " (\"" + std::string(id.AsStringView()) + "\")";
+            }
+
+            JSONValue codes = elementJson["codes"];
+            if (Expect(codes, JSONType::Object, name + ".codes"))
+            {
+                CheckMembers(codes, { "hid", "winvk", "evdev" }, name + ".codes");
+
+                int code = 0;
+                ExpectInt(codes["hid"], name + ".codes.hid", 0, code);
+                ExpectInt(codes["winvk"], name + ".codes.winvk", 0, code);
+                ExpectInt(codes["evdev"], name + ".codes.evdev", 0, code);
+            }
+
+            OverlayElement element;
+            int position[2];
+            if (ExpectInts(elementJson["pos"], name + ".pos", position, 2))
+                element.position = Vector2i(position[0], position[1]);
+
+            // Overrides of inherited elements may keep the parent's sprite
+            JSONValue sprite = elementJson["sprite"];
+            if (!sprite.IsValid())
+            {
+                if (!m_composed)
+                    Error(elementJson, name + " has no sprite");
+                return;
+            }
+            if (!Expect(sprite, JSONType::Object, name + ".sprite"))
+                return;
+
+            // Arrow directions are read by the UI's cursor display
+            CheckMembers(sprite, { "normal", "pressed", "up", "down", "left", "right",
+                                   "up_left", "up_right", "down_left", "down_right" }, name + ".sprite");
+
+            if (!sprite["normal"].IsValid() && !m_composed)
+            {
+                Error(sprite, name + ".sprite has no normal rect");
+                return;
+            }
+
+            struct StateRect
+            {
+                const char* key;
+                IntRect* rect;
+                bool* present;
+            };
+            bool hasNormal = false;
+            StateRect rects[] = {
+                { "normal", &element.sprite.normal, &hasNormal },
+                { "pressed", &element.sprite.pressed, &element.sprite.hasPressedState },
+                { "up", &element.sprite.up, &element.sprite.hasUpState },
+                { "down", &element.sprite.down, &element.sprite.hasDownState },
+            };
+
+            for (StateRect& state : rects)
+            {
+                int rect[4];
+                JSONValue rectJson = sprite[state.key];
+                if (!ExpectInts(rectJson, name + ".sprite." + state.key, rect, 4))
+                    continue;
+
+                if (rect[2] <= 0 || rect[3] <= 0)
+                {
+                    Error(rectJson, name + ".sprite." + state.key + " needs a positive width and height");
+                    continue;
+                }
+
+                *state.rect = IntRect(rect[0], rect[1], rect[2], rect[3]);
+                *state.present = true;
+            }
+
+            for (const char* direction : { "left", "right", "up_left", "up_right", "down_left", "down_right" })
+            {
+                int rect[4];
+                JSONValue rectJson = sprite[direction];
+                if (ExpectInts(rectJson, name + ".sprite." + direction, rect, 4))
+                    CheckTextureRect(rectJson, name + " " + direction + " sprite", IntRect(rect[0], rect[1], rect[2], rect[3]));
+            }
+
+            int z = 0;
+            ExpectInt(elementJson["z"], name + ".z", std::numeric_limits<int>::min(), z);
+            Expect(elementJson["wheel"], JSONType::Bool, name + ".wheel");
+
+            JSONValue cursor = elementJson["cursor"];
+            if (Expect(cursor, JSONType::Object, name + ".cursor"))
+            {
+                CheckMembers(cursor, { "mode", "radius", "sensitivity", "use_monitor_center",
+                                       "monitor_center_x", "monitor_center_y" }, name + ".cursor");
+                Expect(cursor["mode"], JSONType::String, name + ".cursor.mode");
+                Expect(cursor["sensitivity"], JSONType::Number, name + ".cursor.sensitivity");
+                Expect(cursor["use_monitor_center"], JSONType::Bool, name + ".cursor.use_monitor_center");
+
+                int value = 0;
+                ExpectInt(cursor["radius"], name + ".cursor.radius", 0, value);
+                ExpectInt(cursor["monitor_center_x"], name + ".cursor.monitor_center_x", 0, value);
+                ExpectInt(cursor["monitor_center_y"], name + ".cursor.monitor_center_y", 0, value);
+                element.cursor.enabled = true;
+            }
+
+            if (hasNormal)
+            {
+                element.sprite.ResolveStates(m_pressedOffset);
+                CheckBounds(elementJson, name, element);
+            }
+        }
+
+        void CheckOBS(const JSONValue& root, const std::string& presetPath)
+        {
+            OverlayConfig config;
+            if (!OBSPreset::Import(root, config))
+            {
+                Error(root, "not a valid OBS input-overlay preset");
+                return;
+            }
+
+            m_canvasSize = config.canvasSize;
+            if (!presetPath.empty())
+            {
+                std::string textureFile = OBSPreset::FindTextureFile(presetPath);
+                if (textureFile.empty())
+                    Warning(root, "no texture found beside the preset");
+                else
+                    ReadPNGSize(textureFile, m_textureSize);
+            }
+
+            // The importer keeps every object entry, in order
+            size_t index = 0;
+            for (JSONValue elementJson : root["elements"])
+            {
+                if (!elementJson.IsObject() || index >= config.elements.size())
+                    continue;
+
+                const OverlayElement& element = config.elements[index];
+                std::string name = "elements[" + std::to_string(index) + "]";
+                if (!element.id.empty())
+                    name += " (\"" + std::string(element.id) + "\")";
+
+                CheckBounds(elementJson, name, element);
+                ++index;
+            }
+        }
+
+        void CheckTextureRect(const JSONValue& at, const std::string& what, const IntRect& rect, const char* note = "")
+        {
+            if (m_textureSize.x == 0)
+                return;
+
+            if (rect.left < 0 || rect.top < 0 ||
+                rect.left + rect.width > m_textureSize.x || rect.top + rect.height > m_textureSize.y)
+            {
+                Warning(at, what + " " + RectText(rect) + note + " lies outside the " + SizeText(m_textureSize) + " texture");
+            }
+        }
+
+        void CheckBounds(const JSONValue& at, const std::string& name, const OverlayElement& element)
+        {
+            static const char* STATE_NAMES[SPRITE_STATE_COUNT] = { "normal", "pressed", "up", "down" };
+
+            const SpriteInfo& sprite = element.sprite;
+            bool authored[SPRITE_STATE_COUNT] = { true, sprite.hasPressedState, sprite.hasUpState, sprite.hasDownState };
+
+            for (int state = 0; state < SPRITE_STATE_COUNT; ++state)
+            {
+                // Derived states that repeat another rect were checked with it
+                bool derived = !authored[state];
+                if (derived && (state != SPRITE_PRESSED || sprite.states[state] == sprite.normal))
+                    continue;
+
+                CheckTextureRect(at, name + " " + STATE_NAMES[state] + " sprite", sprite.states[state],
+                                 derived ? " (normal moved by defaults.pressed_offset)" : "");
+            }
+
+            // Cursors move around the canvas, only static elements are checked
+            if (m_canvasSize.x > 0 && !element.cursor.enabled)
+            {
+                const Vector2i& position = element.position;
+                if (position.x < 0 || position.y < 0 ||
+                    position.x + sprite.normal.width > m_canvasSize.x || position.y + sprite.normal.height > m_canvasSize.y)
+                {
+                    Warning(at, name + " at [" + std::to_string(position.x) + ", " + std::to_string(position.y) + "] size " +
+                                SizeText(Vector2i(sprite.normal.width, sprite.normal.height)) +
+                                " extends past the " + SizeText(m_canvasSize) + " canvas");
+                }
+            }
+        }
+    };
+}
+
+bool PresetValidator::ValidateText(std::string_view json, const std::string& presetPath, std::vector<PresetIssue>& issues)
+{
+    if (!m_document.Parse(json))
+    {
+        PresetIssue issue;
+        issue.severity = PresetIssue::Severity::Error;
+        m_document.GetLineColumn(m_document.GetErrorOffset(), issue.line, issue.column);
+        issue.message = m_document.GetError();
+        issues.push_back(std::move(issue));
+        return false;
+    }
+
+    return ValidateDocument(m_document, presetPath, issues);
+}
+
+bool PresetValidator::ValidateFile(const std::string& path, std::vector<PresetIssue>& issues)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        issues.push_back({ PresetIssue::Severity::Error, 0, 0, "cannot open the file" });
+        return false;
+    }
+
+    std::string_view json(reinterpret_cast<const char*>(file.Data()), file.Size());
+    return ValidateText(json, path, issues);
+}
+
+bool PresetValidator::ValidateDocument(const JSONDocument& document, const std::string& presetPath, std::vector<PresetIssue>& issues)
+{
+    Checker checker(document, issues);
+    checker.Check(presetPath);
+    return !checker.HasErrors();
+}
+
+size_t PresetValidator::ValidateDirectory(const std::string& directory, std::vector<FileReport>& reports, unsigned threadCount)
+{
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+            files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+
+    reports.clear();
+    reports.resize(files.size());
+    if (files.empty())
+        return 0;
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, files.size()));
+
+    // Workers claim files one at a time; presets vary too much in size for even slices
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        PresetValidator validator;
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            reports[i].path = files[i];
+            reports[i].valid = validator.ValidateFile(files[i], reports[i].issues);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return static_cast<size_t>(std::count_if(reports.begin(), reports.end(),
+        [](const FileReport& report) { return !report.valid; }));
+}
+
+void PresetValidator::PrintIssues(const std::string& path, const std::vector<PresetIssue>& issues)
+{
+    for (const PresetIssue& issue : issues)
+    {
+        std::cerr << path;
+        if (issue.line > 0)
+            std::cerr << ":" << issue.line << ":" << issue.column;
+        std::cerr << (issue.severity == PresetIssue::Severity::Error ? ": error: " : ": warning: ")
+                  << issue.message << std::endl;
+    }
+}
\ No newline at end of file
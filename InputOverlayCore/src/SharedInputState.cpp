@@ -0,0 +1,231 @@
+#include "../include/SharedInputState.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char STATE_MAGIC[4] = { 'A', 'I', 'O', 'S' };
+
+    // An update is a few dozen stores, so a reader that keeps finding one in
+    // progress is looking at a writer that died or was descheduled mid-way
+    const int READ_ATTEMPTS = 1024;
+}
+
+SharedInputState::SharedInputState()
+    : m_block(nullptr)
+    , m_isWriter(false)
+#ifdef _WIN32
+    , m_hMapping(nullptr)
+#endif
+{
+}
+
+SharedInputState::~SharedInputState()
+{
+    Close();
+}
+
+bool SharedInputState::Create(const std::string& name)
+{
+    Close();
+    if (!Map(name, true))
+    {
+        std::cerr << "Failed to create shared input state " << name << std::endl;
+        return false;
+    }
+
+    m_isWriter = true;
+    m_name = name;
+
+    // Fresh mappings are zeroed; the magic goes in last so readers never
+    // accept a half-initialized header
+    m_block->version = STATE_VERSION;
+    m_block->dataOffset = offsetof(Block, words);
+    m_block->dataSize = sizeof(InputStateSnapshot);
+    m_block->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_block->magic, STATE_MAGIC, sizeof(STATE_MAGIC));
+    return true;
+}
+
+bool SharedInputState::Open(const std::string& name)
+{
+    Close();
+    if (!Map(name, false))
+        return false;
+
+    m_name = name;
+    if (std::memcmp(m_block->magic, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0 ||
+        m_block->version != STATE_VERSION || m_block->dataOffset != offsetof(Block, words) ||
+        m_block->dataSize != sizeof(InputStateSnapshot))
+    {
+        std::cerr << "Shared input state " << name << " has an unknown layout" << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void SharedInputState::Publish(const InputStateSnapshot& state)
+{
+    if (!m_block || !m_isWriter)
+        return;
+
+    uint32_t words[WORD_COUNT];
+    std::memcpy(words, &state, sizeof(words));
+
+    // Odd sequence first, so a reader that overlaps the stores below retries
+    uint32_t sequence = m_block->sequence.load(std::memory_order_relaxed);
+    m_block->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int i = 0; i < WORD_COUNT; ++i)
+        m_block->words[i].store(words[i], std::memory_order_relaxed);
+
+    m_block->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool SharedInputState::Read(InputStateSnapshot& state) const
+{
+    if (!m_block)
+        return false;
+
+    uint32_t words[WORD_COUNT];
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+    {
+        uint32_t before = m_block->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+
+        for (int i = 0; i < WORD_COUNT; ++i)
+            words[i] = m_block->words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_block->sequence.load(std::memory_order_relaxed) == before)
+        {
+            std::memcpy(&state, words, sizeof(words));
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t SharedInputState::GetSequence() const
+{
+    return m_block ? m_block->sequence.load(std::memory_order_acquire) : 0;
+}
+
+#ifdef _WIN32
+
+bool SharedInputState::Map(const std::string& name, bool create)
+{
+    // Session-local, like the pipe the UI connects to
+    std::string objectName = "Local\\" + name;
+    if (create)
+    {
+        m_hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        0, sizeof(Block), objectName.c_str());
+    }
+    else
+    {
+        m_hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, objectName.c_str());
+    }
+
+    if (!m_hMapping)
+        return false;
+
+    // Fails if an existing region is smaller than Block
+    void* view = MapViewOfFile(m_hMapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, sizeof(Block));
+    if (!view)
+    {
+        Close();
+        return false;
+    }
+
+    m_block = static_cast<Block*>(view);
+    return true;
+}
+
+void SharedInputState::Close()
+{
+    if (m_block)
+    {
+        UnmapViewOfFile(m_block);
+        m_block = nullptr;
+    }
+
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    m_isWriter = false;
+}
+
+#else
+
+bool SharedInputState::Map(const std::string& name, bool create)
+{
+    std::string objectName = "/" + name;
+    int fd;
+    if (create)
+    {
+        // A region left by a crashed core would keep its stale state
+        shm_unlink(objectName.c_str());
+        fd = shm_open(objectName.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (fd >= 0 && ftruncate(fd, sizeof(Block)) != 0)
+        {
+            close(fd);
+            shm_unlink(objectName.c_str());
+            return false;
+        }
+    }
+    else
+    {
+        fd = shm_open(objectName.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        struct stat info;
+        if (fd >= 0 && (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Block)))
+        {
+            close(fd);
+            return false;
+        }
+    }
+
+    if (fd < 0)
+        return false;
+
+    void* view = mmap(nullptr, sizeof(Block), create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the object alive
+    if (view == MAP_FAILED)
+    {
+        if (create)
+            shm_unlink(objectName.c_str());
+        return false;
+    }
+
+    m_block = static_cast<Block*>(view);
+    return true;
+}
+
+void SharedInputState::Close()
+{
+    if (m_block)
+    {
+        munmap(m_block, sizeof(Block));
+        m_block = nullptr;
+
+        if (m_isWriter)
+            shm_unlink(("/" + m_name).c_str());
+    }
+
+    m_isWriter = false;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "../include/UnixSocketTransport.h"
+#include <iostream>
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    bool MakeAddress(const std::string& path, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            std::cerr << "Invalid IPC socket path: " << path << std::endl;
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        return true;
+    }
+}
+
+UnixSocketTransport::UnixSocketTransport(const std::string& path, Role role)
+    : m_path(path)
+    , m_role(role)
+    , m_listenFd(-1)
+    , m_clientFd(-1)
+    , m_wakeFd(-1)
+    , m_shouldStop(false)
+{
+}
+
+UnixSocketTransport::~UnixSocketTransport()
+{
+    Shutdown();
+
+    if (m_listenFd >= 0)
+    {
+        close(m_listenFd);
+        unlink(m_path.c_str());
+    }
+    if (m_wakeFd >= 0)
+        close(m_wakeFd);
+}
+
+std::string UnixSocketTransport::DefaultPath()
+{
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    std::string directory = (runtimeDir && *runtimeDir) ? runtimeDir : "/tmp";
+    return directory + "/" + IPC_SOCKET_NAME;
+}
+
+bool UnixSocketTransport::Initialize()
+{
+    if (m_wakeFd < 0)
+        m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0)
+    {
+        std::cerr << "eventfd failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Clear a wake-up left by a previous Shutdown()
+    uint64_t count = 0;
+    while (read(m_wakeFd, &count, sizeof(count)) > 0) {}
+    m_shouldStop = false;
+
+    return m_role == Role::Server ? Listen() : Connect();
+}
+
+bool UnixSocketTransport::Listen()
+{
+    sockaddr_un address;
+    if (!MakeAddress(m_path, address))
+        return false;
+
+    // A socket file nobody accepts on is left over from a crashed core
+    int probe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (probe >= 0)
+    {
+        bool inUse = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (inUse)
+        {
+            std::cerr << "IPC socket " << m_path << " is already in use. Please ensure no other instances are running." << std::endl;
+            return false;
+        }
+    }
+    unlink(m_path.c_str());
+
+    m_listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0 ||
+        bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listenFd, 1) != 0)
+    {
+        std::cerr << "Failed to listen on IPC socket " << m_path << ": " << std::strerror(errno) << std::endl;
+        if (m_listenFd >= 0)
+            close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool UnixSocketTransport::Connect()
+{
+    sockaddr_un address;
+    if (!MakeAddress(m_path, address))
+        return false;
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        std::cerr << "Failed to connect to IPC socket " << m_path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    m_clientFd = fd;
+    return true;
+}
+
+void UnixSocketTransport::Shutdown()
+{
+    m_shouldStop = true;
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+    Disconnect();
+}
+
+bool UnixSocketTransport::WaitFor(int fd, short events)
+{
+    pollfd fds[2] = { { fd, events, 0 }, { m_wakeFd, POLLIN, 0 } };
+    while (!m_shouldStop)
+    {
+        int ready = poll(fds, 2, -1);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready < 0)
+            return false;
+        return !m_shouldStop && fds[0].revents != 0;
+    }
+    return false;
+}
+
+bool UnixSocketTransport::WaitForClient()
+{
+    if (m_clientFd >= 0)
+        return true;
+
+    // A client that lost its server stays disconnected until shut down
+    if (m_role == Role::Client)
+    {
+        WaitFor(m_wakeFd, POLLIN);
+        return false;
+    }
+
+    while (WaitFor(m_listenFd, POLLIN))
+    {
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0)
+        {
+            m_clientFd = fd;
+            return true;
+        }
+        if (errno != EINTR && errno != ECONNABORTED)
+        {
+            std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    return false;
+}
+
+void UnixSocketTransport::Disconnect()
+{
+    int fd = m_clientFd.exchange(-1);
+    if (fd < 0)
+        return;
+
+    // Unblocks a reader in poll() and a writer in send(), then waits for
+    // both to let go of the socket before closing it
+    shutdown(fd, SHUT_RDWR);
+    std::scoped_lock lock(m_readMutex, m_writeMutex);
+    close(fd);
+}
+
+bool UnixSocketTransport::Read(std::string& message)
+{
+    std::lock_guard<std::mutex> lock(m_readMutex);
+    int fd = m_clientFd;
+    if (fd < 0 || !WaitFor(fd, POLLIN))
+        return false;
+
+    // MSG_TRUNC reports the full length of the next packet, however large
+    ssize_t size = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+    if (size <= 0)
+        return false;
+
+    message.resize(static_cast<size_t>(size));
+    ssize_t received = recv(fd, &message[0], message.size(), 0);
+    if (received != size)
+    {
+        if (received < 0 && !m_shouldStop)
+            std::cerr << "recv failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool UnixSocketTransport::Write(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    int fd = m_clientFd;
+    if (fd < 0)
+        return false;
+
+    ssize_t sent = send(fd, message.data(), message.size(), MSG_NOSIGNAL);
+    if (sent != static_cast<ssize_t>(message.size()))
+    {
+        if (!m_shouldStop && errno != EPIPE && errno != ECONNRESET)
+            std::cerr << "send failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
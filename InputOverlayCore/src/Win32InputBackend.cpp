@@ -0,0 +1,261 @@
+#include "../include/Win32InputBackend.h"
+#include "../include/KeyCodes.h"
+#include <iostream>
+
+#ifdef _WIN32
+
+Win32InputBackend::Win32InputBackend()
+    : m_hInstance(nullptr)
+    , m_captureThreadId(0)
+    , m_captureWindow(nullptr)
+    , m_hasAbsoluteMouse(false)
+{
+    ZeroMemory(m_keyDown, sizeof(m_keyDown));
+    m_lastAbsoluteMouse.x = 0;
+    m_lastAbsoluteMouse.y = 0;
+}
+
+Win32InputBackend::~Win32InputBackend()
+{
+    Shutdown();
+}
+
+bool Win32InputBackend::Initialize()
+{
+    m_hInstance = GetModuleHandle(nullptr);
+
+    if (!StartCaptureThread())
+    {
+        std::cerr << "Failed to start raw input capture!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void Win32InputBackend::Shutdown()
+{
+    if (m_captureThread.joinable())
+    {
+        PostThreadMessageA(m_captureThreadId, WM_QUIT, 0, 0);
+        m_captureThread.join();
+    }
+}
+
+bool Win32InputBackend::StartCaptureThread()
+{
+    m_capturedEvents.reserve(1024);
+
+    std::promise<bool> started;
+    std::future<bool> result = started.get_future();
+    m_captureThread = std::thread(&Win32InputBackend::CaptureThreadFunc, this, &started);
+
+    if (!result.get())
+    {
+        m_captureThread.join();
+        return false;
+    }
+
+    return true;
+}
+
+void Win32InputBackend::CaptureThreadFunc(std::promise<bool>* started)
+{
+    const char* className = "InputOverlayRawInput";
+
+    WNDCLASSEXA windowClass = {};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = DefWindowProcA;
+    windowClass.hInstance = m_hInstance;
+    windowClass.lpszClassName = className;
+    RegisterClassExA(&windowClass);
+
+    // Message-only window: never visible, only receives WM_INPUT
+    m_captureWindow = CreateWindowExA(0, className, "", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, m_hInstance, nullptr);
+    if (!m_captureWindow)
+    {
+        std::cerr << "Failed to create raw input window: " << GetLastError() << std::endl;
+        started->set_value(false);
+        return;
+    }
+
+    // Generic desktop page: mouse (2) and keyboard (6), delivered even when not focused
+    RAWINPUTDEVICE devices[2];
+    devices[0].usUsagePage = 0x01;
+    devices[0].usUsage = 0x02;
+    devices[0].dwFlags = RIDEV_INPUTSINK;
+    devices[0].hwndTarget = m_captureWindow;
+    devices[1].usUsagePage = 0x01;
+    devices[1].usUsage = 0x06;
+    devices[1].dwFlags = RIDEV_INPUTSINK;
+    devices[1].hwndTarget = m_captureWindow;
+
+    if (!RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)))
+    {
+        std::cerr << "RegisterRawInputDevices failed: " << GetLastError() << std::endl;
+        DestroyWindow(m_captureWindow);
+        m_captureWindow = nullptr;
+        started->set_value(false);
+        return;
+    }
+
+    m_captureThreadId = GetCurrentThreadId();
+    started->set_value(true);
+
+    MSG msg;
+    while (GetMessageA(&msg, nullptr, 0, 0) > 0)
+    {
+        if (msg.message == WM_INPUT)
+        {
+            HandleRawInput(reinterpret_cast<HRAWINPUT>(msg.lParam));
+        }
+
+        // DefWindowProc releases the raw input buffer
+        DispatchMessageA(&msg);
+    }
+
+    devices[0].dwFlags = RIDEV_REMOVE;
+    devices[0].hwndTarget = nullptr;
+    devices[1].dwFlags = RIDEV_REMOVE;
+    devices[1].hwndTarget = nullptr;
+    RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+
+    DestroyWindow(m_captureWindow);
+    m_captureWindow = nullptr;
+    UnregisterClassA(className, m_hInstance);
+}
+
+void Win32InputBackend::HandleRawInput(HRAWINPUT rawInput)
+{
+    uint64_t timestamp = GetInputTimestampNs();
+
+    RAWINPUT input;
+    UINT size = sizeof(input);
+    if (GetRawInputData(rawInput, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1))
+        return;
+
+    if (input.header.dwType == RIM_TYPEKEYBOARD)
+    {
+        const RAWKEYBOARD& keyboard = input.data.keyboard;
+        int virtualKey = keyboard.VKey;
+        bool extended = (keyboard.Flags & RI_KEY_E0) != 0;
+        bool down = (keyboard.Flags & RI_KEY_BREAK) == 0;
+
+        // Raw input reports generic modifiers; resolve the side from the scancode.
+        // E0-prefixed shifts are fake keys sent around navigation keys.
+        switch (virtualKey)
+        {
+        case VK_SHIFT:
+            if (extended)
+                return;
+            virtualKey = (keyboard.MakeCode == 0x36) ? VK_RSHIFT : VK_LSHIFT;
+            break;
+        case VK_CONTROL:
+            virtualKey = extended ? VK_RCONTROL : VK_LCONTROL;
+            break;
+        case VK_MENU:
+            virtualKey = extended ? VK_RMENU : VK_LMENU;
+            break;
+        default:
+            break;
+        }
+
+        if (virtualKey <= 0 || virtualKey >= 0xFF)
+            return;
+
+        CaptureKey(timestamp, virtualKey, down);
+    }
+    else if (input.header.dwType == RIM_TYPEMOUSE)
+    {
+        HandleRawMouse(timestamp, input.data.mouse);
+    }
+}
+
+void Win32InputBackend::HandleRawMouse(uint64_t timestamp, const RAWMOUSE& mouse)
+{
+    if (mouse.usFlags & MOUSE_MOVE_ABSOLUTE)
+    {
+        // Absolute devices report 0..65535 positions; motion is the difference
+        if (m_hasAbsoluteMouse)
+        {
+            m_mouse.AddMotion(timestamp, mouse.lLastX - m_lastAbsoluteMouse.x, mouse.lLastY - m_lastAbsoluteMouse.y);
+        }
+        m_lastAbsoluteMouse.x = mouse.lLastX;
+        m_lastAbsoluteMouse.y = mouse.lLastY;
+        m_hasAbsoluteMouse = true;
+    }
+    else if (mouse.lLastX != 0 || mouse.lLastY != 0)
+    {
+        m_mouse.AddMotion(timestamp, mouse.lLastX, mouse.lLastY);
+    }
+
+    USHORT flags = mouse.usButtonFlags;
+
+    if (flags & RI_MOUSE_WHEEL)
+    {
+        m_mouse.AddWheel(timestamp, static_cast<SHORT>(mouse.usButtonData));
+    }
+
+    if (flags & RI_MOUSE_LEFT_BUTTON_DOWN) CaptureKey(timestamp, VK_LBUTTON, true);
+    if (flags & RI_MOUSE_LEFT_BUTTON_UP) CaptureKey(timestamp, VK_LBUTTON, false);
+    if (flags & RI_MOUSE_RIGHT_BUTTON_DOWN) CaptureKey(timestamp, VK_RBUTTON, true);
+    if (flags & RI_MOUSE_RIGHT_BUTTON_UP) CaptureKey(timestamp, VK_RBUTTON, false);
+    if (flags & RI_MOUSE_MIDDLE_BUTTON_DOWN) CaptureKey(timestamp, VK_MBUTTON, true);
+    if (flags & RI_MOUSE_MIDDLE_BUTTON_UP) CaptureKey(timestamp, VK_MBUTTON, false);
+    if (flags & RI_MOUSE_BUTTON_4_DOWN) CaptureKey(timestamp, VK_XBUTTON1, true);
+    if (flags & RI_MOUSE_BUTTON_4_UP) CaptureKey(timestamp, VK_XBUTTON1, false);
+    if (flags & RI_MOUSE_BUTTON_5_DOWN) CaptureKey(timestamp, VK_XBUTTON2, true);
+    if (flags & RI_MOUSE_BUTTON_5_UP) CaptureKey(timestamp, VK_XBUTTON2, false);
+}
+
+void Win32InputBackend::CaptureKey(uint64_t timestamp, int virtualKey, bool down)
+{
+    // Held keys repeat their make code; only edges are interesting
+    if (m_keyDown[virtualKey] == down)
+        return;
+
+    m_keyDown[virtualKey] = down;
+
+    InputEvent event;
+    event.timestampNs = timestamp;
+    event.type = InputEventType::Key;
+    event.code = virtualKey;
+    event.value = down ? 1 : 0;
+
+    std::lock_guard<std::mutex> lock(m_capturedMutex);
+    m_capturedEvents.push_back(event);
+}
+
+void Win32InputBackend::Poll(std::vector<InputEvent>& events)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_capturedMutex);
+        events.insert(events.end(), m_capturedEvents.begin(), m_capturedEvents.end());
+        m_capturedEvents.clear();
+    }
+
+    uint64_t timestamp = GetInputTimestampNs();
+    MouseAccumulator::AppendEvents(m_mouse.Drain(), timestamp, events);
+    PollCursorPosition(events, timestamp);
+}
+
+void Win32InputBackend::PollCursorPosition(std::vector<InputEvent>& events, uint64_t timestamp)
+{
+    // Screen position for cursor elements; movement comes from raw motion
+    POINT cursorPos;
+    if (!GetCursorPos(&cursorPos))
+        return;
+
+    const int position[2] = { cursorPos.x, cursorPos.y };
+    for (int axis = INPUT_AXIS_X; axis <= INPUT_AXIS_Y; ++axis)
+    {
+        InputEvent event;
+        event.timestampNs = timestamp;
+        event.type = InputEventType::Absolute;
+        event.code = axis;
+        event.value = position[axis];
+        events.push_back(event);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../include/OverlayRenderer.h"
 #include "../include/ConfigParser.h"
 #include "../include/IPCManager.h"
+#include "../include/PresetHotReload.h"
 
 using namespace std;
 
@@ -12,13 +13,44 @@ InputDetection g_inputDetection;
 OverlayRenderer g_overlayRenderer;
 ConfigParser g_configParser;
 IPCManager g_ipcManager;
+PresetHotReload g_hotReload;
 
 // Map to store active overlays
 std::map<int, std::unique_ptr<sf::RenderWindow>> g_overlayWindows;
 std::map<int, OverlayConfig> g_overlayConfigs;
 
+// Overlays reloaded from disk but not drawn yet, with the time the save was seen
+std::map<int, uint64_t> g_pendingReloads;
+
+void ProcessHotReloads()
+{
+    std::vector<PresetReload> reloads;
+    g_hotReload.Poll(g_overlayConfigs, reloads);
+
+    for (const auto& reload : reloads)
+    {
+        const OverlayConfig& config = g_overlayConfigs[reload.overlayId];
+
+        // Only a rewritten PNG is uploaded again
+        if (reload.textureChanged)
+            g_overlayRenderer.ReloadTexture(config.textureFile);
+
+        if (reload.replaced)
+            g_overlayRenderer.RemoveOverlay(reload.overlayId);
+        else
+            g_overlayRenderer.ApplyChanges(reload.overlayId, config, reload.changes);
+
+        cout << "Reloaded overlay " << reload.overlayId << ": " << reload.changes.size()
+             << " element change(s)" << (reload.replaced ? ", elements replaced" : "")
+             << " (parse " << reload.parseMs << " ms)" << endl;
+
+        g_pendingReloads[reload.overlayId] = reload.detectedNs;
+    }
+}
+
 void ProcessIPCMessage(const IPCMessage& message)
 {
+    bool succeeded = true;
     switch (message.type)
     {
     case IPCMessageType::DISPLAY_ALL:
@@ -44,7 +76,8 @@ void ProcessIPCMessage(const IPCMessage& message)
         break;
 
     case IPCMessageType::SHOW_OVERLAY:
-        if (g_overlayWindows.find(message.overlayId) != g_overlayWindows.end())
+        succeeded = g_overlayWindows.find(message.overlayId) != g_overlayWindows.end();
+        if (succeeded)
         {
             auto& window = g_overlayWindows[message.overlayId];
             if (!window || !window->isOpen())
@@ -56,7 +89,8 @@ void ProcessIPCMessage(const IPCMessage& message)
         break;
 
     case IPCMessageType::CLOSE_OVERLAY:
-        if (g_overlayWindows.find(message.overlayId) != g_overlayWindows.end())
+        succeeded = g_overlayWindows.find(message.overlayId) != g_overlayWindows.end();
+        if (succeeded)
         {
             auto& window = g_overlayWindows[message.overlayId];
             if (window && window->isOpen())
@@ -68,11 +102,46 @@ void ProcessIPCMessage(const IPCMessage& message)
 
     case IPCMessageType::ADD_OVERLAY:
         {
+            // Data is the config JSON, or the path of a preset to load and watch
+            size_t first = message.data.find_first_not_of(" \t\r\n");
+            bool isPath = first != std::string::npos && message.data[first] != '{';
+
             OverlayConfig config;
-            if (g_configParser.ParseConfigFromJSON(message.data, config))
+            bool loaded = isPath ? g_configParser.ParseConfigFromFile(message.data, config)
+                                 : g_configParser.ParseConfigFromJSON(message.data, config);
+            if (loaded)
             {
+                if (isPath)
+                    g_hotReload.Track(message.overlayId, message.data, config, g_configParser.GetDependencies());
+                else
+                    g_hotReload.Untrack(message.overlayId);
+
                 g_overlayConfigs[message.overlayId] = config;
                 g_overlayWindows[message.overlayId] = nullptr; // Will be created when shown
+                g_overlayRenderer.RemoveOverlay(message.overlayId);
+            }
+            succeeded = loaded;
+        }
+        break;
+
+    case IPCMessageType::UPDATE_OVERLAY:
+        {
+            // Patch the live config; the window and texture stay as they are
+            auto configIt = g_overlayConfigs.find(message.overlayId);
+            if (configIt == g_overlayConfigs.end())
+            {
+                cerr << "UPDATE_OVERLAY: no overlay with ID " << message.overlayId << endl;
+                succeeded = false;
+                break;
+            }
+
+            std::vector<ConfigChange> changes;
+            succeeded = g_configParser.ApplyPatch(message.data, configIt->second, changes);
+            g_overlayRenderer.ApplyChanges(message.overlayId, configIt->second, changes);
+            if (!succeeded)
+            {
+                cerr << "UPDATE_OVERLAY: some ops for overlay " << message.overlayId << " were rejected ("
+                     << changes.size() << " applied)" << endl;
             }
         }
         break;
@@ -88,10 +157,21 @@ void ProcessIPCMessage(const IPCMessage& message)
                 }
                 g_overlayWindows.erase(windowIt);
             }
-            g_overlayConfigs.erase(message.overlayId);
+            succeeded = g_overlayConfigs.erase(message.overlayId) > 0;
+            g_overlayRenderer.RemoveOverlay(message.overlayId);
+            g_hotReload.Untrack(message.overlayId);
         }
         break;
+
+    case IPCMessageType::STATUS_UPDATE:
+        break;
+
+    default:
+        succeeded = false;
+        break;
     }
+
+    g_ipcManager.SendReply(message, succeeded);
 }
 
 int main()
@@ -117,6 +197,8 @@ int main()
         return 1;
     }
 
+    g_hotReload.Initialize();
+
     cout << "Input Overlay Core initialized successfully." << endl;
 
     // Main loop
@@ -132,6 +214,9 @@ int main()
             ProcessIPCMessage(message);
         }
 
+        // Apply presets saved since the last frame
+        ProcessHotReloads();
+
         // Update input detection
         g_inputDetection.Update();
 
@@ -157,22 +242,21 @@ int main()
                 }
             }
 
-            // Update element states based on input
+            // Update element states based on input (bindings were resolved at load)
             auto& config = g_overlayConfigs[id];
-            for (auto& element : config.elements)
-            {
-                bool wasPressed = element.isPressed;
-                element.isPressed = g_inputDetection.IsKeyPressed(element.key);
-
-                // Send state change notification if needed
-                if (element.isPressed != wasPressed)
-                {
-                    // Could send detailed state updates to UI here
-                }
-            }
+            g_inputDetection.UpdateElementStates(config);
 
             // Render overlay
-            g_overlayRenderer.RenderOverlay(*window, config);
+            g_overlayRenderer.RenderOverlay(id, *window, config);
+
+            // Save-to-screen latency of a hot reload
+            auto pending = g_pendingReloads.find(id);
+            if (pending != g_pendingReloads.end())
+            {
+                cout << "Overlay " << id << " reload visible "
+                     << (GetInputTimestampNs() - pending->second) / 1e6 << " ms after save" << endl;
+                g_pendingReloads.erase(pending);
+            }
         }
 
         // Frame rate limiting
@@ -203,6 +287,7 @@ int main()
         }
     }
 
+    g_hotReload.Shutdown();
     g_ipcManager.Shutdown();
     g_inputDetection.Shutdown();
 
@@ -2,6 +2,14 @@
 #include "../include/InputDetection.h"
 #include "../include/ConfigParser.h"
 #include "../include/IPCManager.h"
+#include "../include/InputRecording.h"
+#include "../include/LayoutGenerator.h"
+#include "../include/MappedFile.h"
+#include "../include/PresetHotReload.h"
+#include "../include/PresetValidator.h"
+#include "../include/SharedInputState.h"
+#include <chrono>
+#include <filesystem>
 
 using namespace std;
 
@@ -10,16 +18,85 @@ bool g_running = true;
 InputDetection g_inputDetection;
 ConfigParser g_configParser;
 IPCManager g_ipcManager;
+PresetHotReload g_hotReload;
+SharedInputState g_sharedInputState;
+InputJournalReader g_journalReader(g_inputDetection.GetJournal()); // Key edges for the shared input state
 
 // Map to store active overlays (simplified)
 std::map<int, OverlayConfig> g_overlayConfigs;
 
 // Mouse state tracking
-MouseEventData g_previousMouseState;
 bool g_hasMouseOverlays = false;
+InputStateSnapshot g_inputState = {}; // Keeps the running totals between frames
+
+void UpdateMouseOverlayFlag(const OverlayConfig& config)
+{
+    // Check if this overlay has cursor elements
+    for (const auto& element : config.elements)
+    {
+        if (element.cursor.enabled)
+        {
+            g_hasMouseOverlays = true;
+            break;
+        }
+    }
+}
+
+// ADD_OVERLAY data is either the config JSON or the path of a preset file;
+// presets loaded from a file are reloaded when the file changes
+bool LoadOverlay(int overlayId, const std::string& data)
+{
+    size_t first = data.find_first_not_of(" \t\r\n");
+    bool isPath = first != std::string::npos && data[first] != '{';
+
+    OverlayConfig config;
+    bool loaded = isPath ? g_configParser.ParseConfigFromFile(data, config)
+                         : g_configParser.ParseFromString(data, config);
+    if (!loaded)
+        return false;
+
+    if (isPath)
+        g_hotReload.Track(overlayId, data, config, g_configParser.GetDependencies());
+    else
+        g_hotReload.Untrack(overlayId);
+
+    UpdateMouseOverlayFlag(config);
+    g_overlayConfigs[overlayId] = std::move(config);
+    return true;
+}
+
+void ProcessHotReloads()
+{
+    std::vector<PresetReload> reloads;
+    g_hotReload.Poll(g_overlayConfigs, reloads);
+
+    for (const auto& reload : reloads)
+    {
+        size_t counts[3] = {};
+        for (const auto& change : reload.changes)
+        {
+            ++counts[static_cast<int>(change.kind)];
+        }
+
+        // No window here, so "live" is when the next Update() sees the new config
+        double liveMs = (GetInputTimestampNs() - reload.detectedNs) / 1e6;
+
+        cout << "Reloaded overlay " << reload.overlayId << ": ";
+        if (reload.replaced)
+            cout << "elements replaced";
+        else
+            cout << counts[0] << " updated, " << counts[1] << " added, " << counts[2] << " removed";
+        if (reload.textureChanged)
+            cout << ", texture changed";
+        cout << " (parse " << reload.parseMs << " ms, live " << liveMs << " ms after save)" << endl;
+
+        UpdateMouseOverlayFlag(g_overlayConfigs[reload.overlayId]);
+    }
+}
 
 void ProcessIPCMessage(const IPCMessage& message)
 {
+    bool succeeded = true;
     switch (message.type)
     {
     case IPCMessageType::DISPLAY_ALL:
@@ -43,38 +120,45 @@ void ProcessIPCMessage(const IPCMessage& message)
         cout << "Processing ADD_OVERLAY for ID: " << message.overlayId << endl;
 
         // Try to parse the configuration
-        OverlayConfig config;
-        if (g_configParser.ParseFromString(message.data, config))
+        if (LoadOverlay(message.overlayId, message.data))
         {
-            g_overlayConfigs[message.overlayId] = config;
-
-            // Check if this overlay has cursor elements
-            for (const auto& element : config.elements)
-            {
-                if (element.cursor.enabled)
-                {
-                    g_hasMouseOverlays = true;
-                    break;
-                }
-            }
-
             cout << "Successfully added overlay configuration" << endl;
         }
         else
         {
             cout << "Failed to parse overlay configuration" << endl;
+            succeeded = false;
         }
         break;
     }
 
     case IPCMessageType::REMOVE_OVERLAY:
         cout << "Processing REMOVE_OVERLAY for ID: " << message.overlayId << endl;
-        g_overlayConfigs.erase(message.overlayId);
+        succeeded = g_overlayConfigs.erase(message.overlayId) > 0;
+        g_hotReload.Untrack(message.overlayId);
         break;
 
     case IPCMessageType::UPDATE_OVERLAY:
+    {
         cout << "Processing UPDATE_OVERLAY for ID: " << message.overlayId << endl;
+
+        auto configIt = g_overlayConfigs.find(message.overlayId);
+        if (configIt == g_overlayConfigs.end())
+        {
+            cout << "No overlay with that ID" << endl;
+            succeeded = false;
+            break;
+        }
+
+        // Edit the live config in place instead of re-adding the overlay
+        std::vector<ConfigChange> changes;
+        bool applied = g_configParser.ApplyPatch(message.data, configIt->second, changes);
+        UpdateMouseOverlayFlag(configIt->second);
+        succeeded = applied;
+
+        cout << "Applied " << changes.size() << " element change(s)" << (applied ? "" : ", some were rejected") << endl;
         break;
+    }
 
     case IPCMessageType::STATUS_UPDATE:
         cout << "Processing STATUS_UPDATE" << endl;
@@ -82,77 +166,317 @@ void ProcessIPCMessage(const IPCMessage& message)
 
     default:
         cout << "Unknown IPC message type" << endl;
+        succeeded = false;
         break;
     }
+
+    g_ipcManager.SendReply(message, succeeded);
 }
 
 void SendMouseEventUpdate()
 {
-    if (!g_hasMouseOverlays)
+    // Mouse events are live state; nothing is queued for a UI that is not there
+    int count = g_inputDetection.GetMouseSampleCount();
+    if (!g_hasMouseOverlays || count == 0 || !g_ipcManager.IsConnected())
         return;
 
-    // Get current mouse state
-    MouseEventData currentMouseState;
-    currentMouseState.position = g_inputDetection.GetMousePosition();
-    currentMouseState.movement = g_inputDetection.GetMouseMovement();
-    currentMouseState.wheelDelta = g_inputDetection.GetMouseWheelDelta();
-    currentMouseState.leftButton = g_inputDetection.IsMouseButtonPressed(1);
-    currentMouseState.rightButton = g_inputDetection.IsMouseButtonPressed(2);
-    currentMouseState.middleButton = g_inputDetection.IsMouseButtonPressed(3);
-    currentMouseState.xButton1 = g_inputDetection.IsMouseButtonPressed(5);
-    currentMouseState.xButton2 = g_inputDetection.IsMouseButtonPressed(4);
-
-    // Check if anything changed
-    bool hasChanged =
-        (currentMouseState.position.x != g_previousMouseState.position.x) ||
-        (currentMouseState.position.y != g_previousMouseState.position.y) ||
-        (currentMouseState.movement.x != 0) ||
-        (currentMouseState.movement.y != 0) ||
-        (currentMouseState.wheelDelta != 0) ||
-        (currentMouseState.leftButton != g_previousMouseState.leftButton) ||
-        (currentMouseState.rightButton != g_previousMouseState.rightButton) ||
-        (currentMouseState.middleButton != g_previousMouseState.middleButton) ||
-        (currentMouseState.xButton1 != g_previousMouseState.xButton1) ||
-        (currentMouseState.xButton2 != g_previousMouseState.xButton2);
-
-    if (hasChanged)
-    {
-        // Create a simple JSON representation of mouse data
-        std::string mouseData = "{";
-        mouseData += "\"position\":[" + std::to_string(currentMouseState.position.x) + "," + std::to_string(currentMouseState.position.y) + "],";
-        mouseData += "\"movement\":[" + std::to_string(currentMouseState.movement.x) + "," + std::to_string(currentMouseState.movement.y) + "],";
-        mouseData += "\"wheelDelta\":" + std::to_string(currentMouseState.wheelDelta) + ",";
-        mouseData += "\"leftButton\":" + std::string(currentMouseState.leftButton ? "true" : "false") + ",";
-        mouseData += "\"rightButton\":" + std::string(currentMouseState.rightButton ? "true" : "false") + ",";
-        mouseData += "\"middleButton\":" + std::string(currentMouseState.middleButton ? "true" : "false") + ",";
-        mouseData += "\"xButton1\":" + std::string(currentMouseState.xButton1 ? "true" : "false") + ",";
-        mouseData += "\"xButton2\":" + std::string(currentMouseState.xButton2 ? "true" : "false");
-        mouseData += "}";
-
-        // Send mouse event message
-        IPCMessage mouseMessage;
-        mouseMessage.type = IPCMessageType::MOUSE_EVENT;
-        mouseMessage.overlayId = 0; // Mouse events are global
-        mouseMessage.data = mouseData;
-
-        g_ipcManager.SendMessage(mouseMessage);
-
-        // Update previous state
-        g_previousMouseState = currentMouseState;
+    uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+    size_t size = MouseEventCodec::Encode(g_inputDetection.GetMouseSamples(), count, packet);
+
+    IPCMessage mouseMessage;
+    mouseMessage.type = IPCMessageType::MOUSE_EVENT;
+    mouseMessage.overlayId = 0; // Mouse events are global
+
+    // A payload buffer the writer already sent, moved through the queue:
+    // after the first few frames nothing here allocates
+    mouseMessage.data = g_ipcManager.TakePayloadBuffer();
+    mouseMessage.data.assign(reinterpret_cast<const char*>(packet), size);
+
+    g_ipcManager.SendMessage(std::move(mouseMessage));
+}
+
+// Publishes this frame's input to the shared-memory region local readers poll
+void PublishInputState()
+{
+    if (!g_sharedInputState.IsOpen())
+        return;
+
+    InputStateSnapshot& state = g_inputState;
+    state.timestampNs = g_inputDetection.GetFrameTimeNs();
+
+    // Every edge since the last frame, taps shorter than a frame included
+    g_journalReader.Read([&state](const InputRecord& record) { state.keysChangedNs = record.timestampNs; });
+
+    const KeyStateSet& keys = g_inputDetection.GetKeyStates();
+    const KeyStateSet& latched = g_inputDetection.GetLatchedKeys();
+    for (int i = 0; i < KeyStateSet::WORD_COUNT; ++i)
+    {
+        state.keys[i] = keys.Word(i);
+        state.keysLatched[i] = latched.Word(i);
     }
+
+    Vector2i position = g_inputDetection.GetMousePosition();
+    Vector2i movement = g_inputDetection.GetMouseMovement();
+    state.mouseX = position.x;
+    state.mouseY = position.y;
+    state.deltaX = movement.x;
+    state.deltaY = movement.y;
+    state.wheelDelta = g_inputDetection.GetMouseWheelDelta();
+    state.totalDeltaX += state.deltaX;
+    state.totalDeltaY += state.deltaY;
+    state.totalWheel += state.wheelDelta;
+
+    g_sharedInputState.Publish(state);
 }
 
-int main()
+// Compiles every preset under 'path' (a file or a directory tree) into its
+// .aiocache, translating OBS input-overlay presets on the way
+int ImportPresets(const std::string& path)
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".json")
+                files.push_back(entry.path());
+        }
+    }
+    else
+    {
+        files.push_back(path);
+    }
+
+    ConfigParser parser;
+    size_t imported = 0;
+    size_t elements = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto& file : files)
+    {
+        OverlayConfig config;
+        if (parser.ParseConfigFromFile(file.string(), config))
+        {
+            ++imported;
+            elements += config.elements.size();
+        }
+        else
+        {
+            cout << "Failed to import " << file.string() << endl;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    cout << "Imported " << imported << " of " << files.size() << " presets (" << elements << " elements) in " << ms << " ms" << endl;
+    return imported == files.size() ? 0 : -1;
+}
+
+// Loads any supported preset and writes it back in the native schema
+int ExportPreset(const std::string& inputPath, const std::string& outputPath)
+{
+    ConfigParser parser;
+    parser.SetCacheEnabled(false);
+
+    OverlayConfig config;
+    if (!parser.ParseConfigFromFile(inputPath, config) || !parser.SaveConfigToFile(outputPath, config))
+    {
+        cout << "Failed to export " << inputPath << endl;
+        return -1;
+    }
+
+    cout << "Exported " << config.elements.size() << " elements to " << outputPath << endl;
+    return 0;
+}
+
+// Checks a preset, or every preset under a directory in parallel, and
+// prints errors and warnings with their line and column
+int ValidatePresets(const std::string& path)
+{
+    std::vector<PresetValidator::FileReport> reports;
+    size_t invalid = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error))
+    {
+        invalid = PresetValidator::ValidateDirectory(path, reports);
+    }
+    else
+    {
+        PresetValidator validator;
+        reports.resize(1);
+        reports[0].path = path;
+        reports[0].valid = validator.ValidateFile(path, reports[0].issues);
+        invalid = reports[0].valid ? 0 : 1;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t warnings = 0;
+    for (const auto& report : reports)
+    {
+        PresetValidator::PrintIssues(report.path, report.issues);
+        for (const auto& issue : report.issues)
+        {
+            if (issue.severity == PresetIssue::Severity::Warning)
+                ++warnings;
+        }
+    }
+
+    cout << "Validated " << reports.size() << " presets in " << ms << " ms: "
+         << invalid << " invalid, " << warnings << " warnings" << endl;
+    return invalid == 0 ? 0 : -1;
+}
+
+// Builds a keyboard preset from a layout description file, or from a
+// built-in layout name with default sizes, and writes it with its cache
+int GeneratePreset(const std::string& layout, const std::string& outputPath, bool compile)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    OverlayConfig config;
+    bool generated = false;
+    if (LayoutGenerator::FindBuiltinLayout(layout))
+    {
+        // A built-in name is plain text; the output name is set afterwards
+        // so it never needs escaping
+        generated = LayoutGenerator::GenerateFromText("{ \"layout\": \"" + layout + "\" }", config);
+
+        // Sheet "<preset>.png": normal keys on top, pressed keys below
+        config.textureFile = std::filesystem::path(outputPath).stem().string() + ".png";
+    }
+    else
+    {
+        MappedFile file;
+        generated = file.Open(layout) &&
+                    LayoutGenerator::GenerateFromText(std::string_view(reinterpret_cast<const char*>(file.Data()), file.Size()), config);
+    }
+
+    if (!generated || !LayoutGenerator::Save(config, outputPath, compile))
+    {
+        cout << "Failed to generate " << outputPath << " from " << layout << endl;
+        return -1;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    cout << "Generated " << config.elements.size() << " elements (canvas " << config.canvasSize.x << "x"
+         << config.canvasSize.y << ") to " << outputPath << " in " << ms << " ms" << endl;
+    return 0;
+}
+
+void PrintUsage()
+{
+    cout << "Usage: InputOverlayCore [options]" << endl;
+    cout << "  --record <file.aiorec>   Record all input events to a file" << endl;
+    cout << "  --replay <file.aiorec>   Use a recording instead of live input" << endl;
+    cout << "  --replay-fast            Replay one frame step per update without waiting, exit when done" << endl;
+    cout << "  --no-cache               Always parse preset JSON, never read or write .aiocache files" << endl;
+    cout << "  --import <path>          Compile a preset or a folder of presets (OBS format included) and exit" << endl;
+    cout << "  --export <in> <out>      Convert a preset (OBS format included) to native JSON and exit" << endl;
+    cout << "  --preset <file.json>     Load a preset as an overlay and reload it whenever it is saved" << endl;
+    cout << "  --validate <path>        Check a preset or a folder of presets against the schema and exit" << endl;
+    cout << "  --generate <layout> <out.json>  Build a keyboard preset from a layout file or ansi104/ansi60 and exit" << endl;
+}
+
+int main(int argc, char* argv[])
 {
     cout << INPUT_OVERLAY_VERSION << " - Starting Core Engine..." << endl;
 
+    std::string recordPath;
+    std::string replayPath;
+    bool replayFast = false;
+    bool useCache = true;
+    std::vector<std::string> presetPaths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--replay-fast")
+        {
+            replayFast = true;
+        }
+        else if (arg == "--no-cache")
+        {
+            useCache = false;
+        }
+        else if (arg == "--import" && i + 1 < argc)
+        {
+            return ImportPresets(argv[++i]);
+        }
+        else if (arg == "--preset" && i + 1 < argc)
+        {
+            presetPaths.push_back(argv[++i]);
+        }
+        else if (arg == "--validate" && i + 1 < argc)
+        {
+            return ValidatePresets(argv[++i]);
+        }
+        else if (arg == "--generate" && i + 2 < argc)
+        {
+            return GeneratePreset(argv[i + 1], argv[i + 2], useCache);
+        }
+        else if (arg == "--export" && i + 2 < argc)
+        {
+            return ExportPreset(argv[i + 1], argv[i + 2]);
+        }
+        else
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
     // Initialize input detection
-    if (!g_inputDetection.Initialize())
+    ReplayInputBackend* replay = nullptr;
+    bool inputReady = false;
+    if (!replayPath.empty())
+    {
+        auto backend = std::make_unique<ReplayInputBackend>(replayPath, replayFast ? ReplayMode::Fast : ReplayMode::Realtime);
+        replay = backend.get();
+        inputReady = g_inputDetection.Initialize(std::move(backend));
+    }
+    else
+    {
+        inputReady = g_inputDetection.Initialize();
+    }
+
+    if (!inputReady)
     {
         cout << "Failed to initialize input detection!" << endl;
         return -1;
     }
 
+    if (!recordPath.empty() && !g_inputDetection.StartRecording(recordPath))
+    {
+        cout << "Failed to start recording!" << endl;
+        return -1;
+    }
+
+    // Compiled presets for configs sent over the pipe
+    g_configParser.SetCacheEnabled(useCache);
+    if (useCache)
+    {
+        g_configParser.SetCacheDirectory("PresetCache");
+    }
+
+    g_hotReload.Initialize();
+    for (size_t i = 0; i < presetPaths.size(); ++i)
+    {
+        if (!LoadOverlay(static_cast<int>(i) + 1, presetPaths[i]))
+        {
+            cout << "Failed to load preset " << presetPaths[i] << endl;
+        }
+    }
+
     // Initialize IPC
     if (!g_ipcManager.Initialize())
     {
@@ -160,32 +484,67 @@ int main()
         return -1;
     }
 
+    // Optional: overlays still get everything over IPC without it
+    if (!g_sharedInputState.Create())
+    {
+        cout << "Shared input state unavailable; local readers will not see input." << endl;
+    }
+
     cout << "Core engine initialized successfully!" << endl;
     cout << "Waiting for IPC messages..." << endl;
 
     // Main loop
+    IPCMessage message;
     while (g_running)
     {
-        // Check for IPC messages
-        IPCMessage message;
-        if (g_ipcManager.ReceiveMessage(message))
+        auto frameStart = std::chrono::steady_clock::now();
+
+        // Everything the UI sent since the last pass
+        while (g_ipcManager.ReceiveMessage(message))
         {
             ProcessIPCMessage(message);
         }
 
+        // Pick up presets saved since the last frame
+        ProcessHotReloads();
+
         // Update input detection
         g_inputDetection.Update();
+        PublishInputState();
 
         // Send mouse events if needed
         SendMouseEventUpdate();
 
-        // Small delay to prevent high CPU usage
-        Sleep(16); // ~60 FPS equivalent
+        if (replay && replayFast)
+        {
+            // Deterministic replay runs unthrottled and ends with the recording
+            if (replay->IsFinished())
+            {
+                cout << "Replay finished: " << replay->GetEventCount() << " events." << endl;
+                g_running = false;
+            }
+            continue;
+        }
+
+        // Sleep out the frame (~60 FPS), but answer requests that arrive
+        // meanwhile right away instead of on the next frame
+        auto nextFrame = frameStart + std::chrono::milliseconds(16);
+        while (g_ipcManager.WaitForMessage(nextFrame))
+        {
+            while (g_ipcManager.ReceiveMessage(message))
+            {
+                ProcessIPCMessage(message);
+            }
+        }
     }
 
     cout << "Shutting down core engine..." << endl;
 
+    g_hotReload.Shutdown();
     g_inputDetection.Cleanup();
+    g_sharedInputState.Close();
+    if (g_journalReader.GetDropped() > 0)
+        cout << "Input journal: " << g_journalReader.GetDropped() << " key edges were overwritten before being published." << endl;
     g_ipcManager.Cleanup();
 
     return 0;
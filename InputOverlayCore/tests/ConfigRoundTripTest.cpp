@@ -0,0 +1,141 @@
+#include "ConfigParser.h"
+#include "LayoutGenerator.h"
+#include "PresetHotReload.h"
+#include <algorithm>
+#include <cstdio>
+
+// ConfigToJSON output must parse back into the same config: every bundled
+// preset (native and OBS format) and the built-in generated layouts, written
+// both compact and indented.
+namespace
+{
+    bool SameColor(const Color& a, const Color& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    // ElementsEqual compares resolved sprites; the written rects and which of
+    // them were set must survive as well, or defaults would apply differently
+    bool SameElement(const OverlayElement& a, const OverlayElement& b)
+    {
+        return PresetHotReload::ElementsEqual(a, b) &&
+            a.key.stateIndex == b.key.stateIndex &&
+            a.sprite.normal == b.sprite.normal &&
+            (!a.sprite.hasPressedState || a.sprite.pressed == b.sprite.pressed) &&
+            (!a.sprite.hasUpState || a.sprite.up == b.sprite.up) &&
+            (!a.sprite.hasDownState || a.sprite.down == b.sprite.down);
+    }
+
+    // Empty if equal, otherwise what differs first
+    std::string Compare(const OverlayConfig& a, const OverlayConfig& b)
+    {
+        if (a.version != b.version)
+            return "version";
+        if (a.textureFile != b.textureFile || !(a.textureSize == b.textureSize))
+            return "texture";
+        if (!(a.canvasSize == b.canvasSize) || !SameColor(a.backgroundColor, b.backgroundColor))
+            return "canvas";
+        if (!(a.defaultPressedOffset == b.defaultPressedOffset) || a.latchTaps != b.latchTaps ||
+            a.minPressDurationMs != b.minPressDurationMs)
+            return "defaults";
+        if (a.elements.size() != b.elements.size())
+            return "element count";
+        for (size_t i = 0; i < a.elements.size(); ++i)
+        {
+            if (!SameElement(a.elements[i], b.elements[i]))
+                return "element " + std::to_string(i) + " (" + std::string(a.elements[i].id) + ")";
+        }
+        if (a.keyStateIndices != b.keyStateIndices)
+            return "key state indices";
+        return std::string();
+    }
+
+    int failures = 0;
+
+    void CheckRoundTrip(ConfigParser& parser, const std::string& name, const OverlayConfig& original)
+    {
+        int failuresBefore = failures;
+        for (bool pretty : { false, true })
+        {
+            OverlayConfig reparsed;
+            std::string json = parser.ConfigToJSON(original, pretty);
+            if (!parser.ParseFromString(json, reparsed))
+            {
+                std::fprintf(stderr, "FAIL %s%s: output does not parse\n", name.c_str(), pretty ? " (pretty)" : "");
+                ++failures;
+                continue;
+            }
+
+            std::string difference = Compare(original, reparsed);
+            if (!difference.empty())
+            {
+                std::fprintf(stderr, "FAIL %s%s: %s differs\n", name.c_str(), pretty ? " (pretty)" : "", difference.c_str());
+                ++failures;
+            }
+        }
+        if (failures == failuresBefore)
+            std::printf("ok   %s (%zu elements)\n", name.c_str(), original.elements.size());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <repository root>\n", argv[0]);
+        return 2;
+    }
+    const std::filesystem::path root = argv[1];
+
+    ConfigParser parser;
+    parser.SetCacheEnabled(false);
+
+    int presets = 0;
+    for (const char* directory : { "Presets", "obs-preset" })
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root / directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".json")
+                files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files)
+        {
+            std::string name = std::filesystem::relative(file, root).generic_string();
+            OverlayConfig original;
+            if (!parser.ParseConfigFromFile(file.string(), original))
+            {
+                std::fprintf(stderr, "FAIL %s: does not load\n", name.c_str());
+                ++failures;
+                continue;
+            }
+            CheckRoundTrip(parser, name, original);
+            ++presets;
+        }
+    }
+
+    if (presets == 0)
+    {
+        std::fprintf(stderr, "FAIL no presets found under %s\n", root.string().c_str());
+        ++failures;
+    }
+
+    for (const char* layout : { "ansi104", "ansi60" })
+    {
+        std::string description = std::string("{ \"layout\": \"") + layout +
+            "\", \"texture\": { \"file\": \"keyboard.png\" }, \"key_size\": [50, 50], \"spacing\": 4 }";
+        OverlayConfig generated;
+        if (!LayoutGenerator::GenerateFromText(description, generated))
+        {
+            std::fprintf(stderr, "FAIL %s: layout does not generate\n", layout);
+            ++failures;
+            continue;
+        }
+        parser.ResolveKeyBindings(generated);
+        CheckRoundTrip(parser, std::string("generated ") + layout, generated);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
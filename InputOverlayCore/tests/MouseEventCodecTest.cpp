@@ -0,0 +1,233 @@
+#include "MouseEventCodec.h"
+#include <cstdio>
+#include <cstring>
+
+// MouseEventCodec packets must decode back to the samples they were encoded
+// from, and every truncated or corrupted packet must be rejected or decode
+// within bounds instead of reading past the buffer.
+namespace
+{
+    int failures = 0;
+
+    void Fail(const char* name, const char* what)
+    {
+        std::fprintf(stderr, "FAIL %s: %s\n", name, what);
+        ++failures;
+    }
+
+    bool SameSample(const MouseSample& a, const MouseSample& b)
+    {
+        // The wire carries microseconds
+        return a.timestampNs / 1000 * 1000 == b.timestampNs && a.position == b.position &&
+            a.movement == b.movement && a.wheelDelta == b.wheelDelta && a.buttons == b.buttons;
+    }
+
+    uint32_t seed = 2024;
+
+    uint32_t NextRandom()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed;
+    }
+
+    // Mostly small deltas, with the occasional extreme value
+    int RandomValue()
+    {
+        uint32_t r = NextRandom();
+        switch (r % 8)
+        {
+        case 0: return 0;
+        case 1: return static_cast<int>(r >> 16) % 3 - 1;
+        case 2: return (r & 0x100) ? INT32_MAX : INT32_MIN;
+        default: return static_cast<int>(r >> 20) - 2048;
+        }
+    }
+
+    // Positions wrap like the codec's deltas do
+    int WrappingAdd(int a, int b)
+    {
+        return static_cast<int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+    }
+
+    int RandomSamples(MouseSample* samples)
+    {
+        int count = 1 + static_cast<int>(NextRandom() % MouseEventCodec::MAX_SAMPLES);
+        uint64_t timeNs = (NextRandom() & 1) ? 0 : static_cast<uint64_t>(NextRandom()) * 1000000ull;
+        Vector2i position(RandomValue(), RandomValue());
+        for (int i = 0; i < count; ++i)
+        {
+            MouseSample& sample = samples[i];
+            sample = MouseSample();
+            timeNs += NextRandom() % 4000000;
+            sample.timestampNs = timeNs;
+            if (NextRandom() % 2)
+                position = Vector2i(WrappingAdd(position.x, RandomValue()), WrappingAdd(position.y, RandomValue()));
+            sample.position = position;
+            if (NextRandom() % 2)
+                sample.movement = Vector2i(RandomValue(), RandomValue());
+            if (NextRandom() % 4 == 0)
+                sample.wheelDelta = RandomValue();
+            sample.buttons = static_cast<uint8_t>(NextRandom() & 0x1F);
+        }
+        return count;
+    }
+
+    void CheckRoundTrip(const char* name, const MouseSample* samples, int count)
+    {
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(samples, count, packet);
+        if (size > MouseEventCodec::MAX_PACKET_SIZE)
+        {
+            Fail(name, "packet larger than MAX_PACKET_SIZE");
+            return;
+        }
+
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int decodedCount = 0;
+        if (!MouseEventCodec::Decode(packet, size, decoded, decodedCount) || decodedCount != count)
+        {
+            Fail(name, "does not decode");
+            return;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            if (!SameSample(samples[i], decoded[i]))
+            {
+                Fail(name, "sample differs");
+                return;
+            }
+        }
+
+        // Every prefix is truncated, and so is a packet with a byte appended
+        for (size_t length = 0; length < size; ++length)
+        {
+            if (MouseEventCodec::Decode(packet, length, decoded, decodedCount))
+            {
+                Fail(name, "truncated packet decodes");
+                return;
+            }
+        }
+        uint8_t longer[MouseEventCodec::MAX_PACKET_SIZE + 1];
+        std::memcpy(longer, packet, size);
+        longer[size] = 0;
+        if (MouseEventCodec::Decode(longer, size + 1, decoded, decodedCount))
+            Fail(name, "packet with trailing bytes decodes");
+    }
+}
+
+int main()
+{
+    // Plain motion, a sub-frame click and a wheel step, as InputDetection sends them
+    MouseSample frame[4];
+    frame[0].timestampNs = 1000002000000ull;
+    frame[0].position = Vector2i(960, 540);
+    frame[0].movement = Vector2i(3, -2);
+    frame[1] = frame[0];
+    frame[1].timestampNs += 500000;
+    frame[1].position = Vector2i(963, 538);
+    frame[1].movement = Vector2i();
+    frame[2] = frame[1];
+    frame[2].timestampNs += 3500000;
+    frame[2].buttons = MOUSE_BUTTON_LEFT;
+    frame[3] = frame[2];
+    frame[3].timestampNs += 3000000;
+    frame[3].buttons = 0;
+    frame[3].wheelDelta = -120;
+    CheckRoundTrip("frame", frame, 4);
+
+    // Extremes: full-range positions and deltas, every button, a clock that
+    // went backwards (encoded as no gap)
+    MouseSample extremes[3];
+    extremes[0].timestampNs = UINT64_MAX / 1000 * 1000;
+    extremes[0].position = Vector2i(INT32_MIN, INT32_MAX);
+    extremes[0].movement = Vector2i(INT32_MAX, INT32_MIN);
+    extremes[0].wheelDelta = INT32_MIN;
+    extremes[0].buttons = 0x1F;
+    extremes[1] = extremes[0];
+    extremes[1].position = Vector2i(INT32_MAX, INT32_MIN);
+    extremes[2] = extremes[1];
+    extremes[2].timestampNs = 5000;
+    {
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(extremes, 3, packet);
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int count = 0;
+        if (!MouseEventCodec::Decode(packet, size, decoded, count) || count != 3 ||
+            decoded[2].timestampNs != extremes[0].timestampNs || decoded[2].position != extremes[2].position ||
+            decoded[0].wheelDelta != INT32_MIN || decoded[0].buttons != 0x1F)
+        {
+            Fail("extremes", "do not round-trip");
+        }
+    }
+
+    for (int i = 0; i < 20000 && failures == 0; ++i)
+    {
+        MouseSample samples[MouseEventCodec::MAX_SAMPLES];
+        int count = RandomSamples(samples);
+        CheckRoundTrip("random batch", samples, count);
+    }
+
+    // Encode() clamps to MAX_SAMPLES
+    {
+        MouseSample many[MouseEventCodec::MAX_SAMPLES + 8];
+        for (int i = 0; i < MouseEventCodec::MAX_SAMPLES + 8; ++i)
+            many[i].timestampNs = static_cast<uint64_t>(i) * 1000;
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(many, MouseEventCodec::MAX_SAMPLES + 8, packet);
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int count = 0;
+        if (!MouseEventCodec::Decode(packet, size, decoded, count) || count != MouseEventCodec::MAX_SAMPLES)
+            Fail("too many samples", "not clamped to MAX_SAMPLES");
+    }
+
+    // Malformed headers and fields
+    struct Malformed
+    {
+        const char* name;
+        uint8_t bytes[16];
+        size_t size;
+    };
+    const Malformed malformed[] = {
+        { "empty", {}, 0 },
+        { "wrong version", { 2, 1, 0, 0 }, 4 },
+        { "zero samples", { 1, 0 }, 2 },
+        { "too many samples", { 1, MouseEventCodec::MAX_SAMPLES + 1, 0, 0 }, 4 },
+        { "overlong count varint", { 1, 0x81, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0 }, 12 },
+        { "overlong time varint", { 1, 1, 0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1 }, 14 },
+        { "position past 32 bits", { 1, 1, MouseEventCodec::SAMPLE_POSITION, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0 }, 10 },
+        { "missing movement", { 1, 1, MouseEventCodec::SAMPLE_MOVEMENT, 0, 2 }, 5 },
+        { "missing wheel", { 1, 1, MouseEventCodec::SAMPLE_WHEEL, 0 }, 4 },
+        { "missing second sample", { 1, 2, 0, 0 }, 4 },
+    };
+    for (const Malformed& packet : malformed)
+    {
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int count = -1;
+        if (MouseEventCodec::Decode(packet.bytes, packet.size, decoded, count) || count != -1)
+            Fail(packet.name, "malformed packet decodes");
+    }
+
+    // Random corruption of a valid packet: decoding must stay in bounds, and a
+    // packet it accepts must hold a valid sample count
+    for (int i = 0; i < 20000; ++i)
+    {
+        MouseSample samples[MouseEventCodec::MAX_SAMPLES];
+        int count = RandomSamples(samples);
+        uint8_t packet[MouseEventCodec::MAX_PACKET_SIZE];
+        size_t size = MouseEventCodec::Encode(samples, count, packet);
+        packet[NextRandom() % size] ^= static_cast<uint8_t>(1 + NextRandom() % 255);
+
+        MouseSample decoded[MouseEventCodec::MAX_SAMPLES];
+        int decodedCount = 0;
+        if (MouseEventCodec::Decode(packet, size, decoded, decodedCount) &&
+            (decodedCount < 1 || decodedCount > MouseEventCodec::MAX_SAMPLES))
+        {
+            Fail("corrupted packet", "decodes to an invalid sample count");
+            break;
+        }
+    }
+
+    if (failures == 0)
+        std::printf("ok   MouseEventCodec round trips and rejects malformed packets\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
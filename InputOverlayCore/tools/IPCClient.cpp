@@ -0,0 +1,143 @@
+#include "IPCManager.h"
+#include "MappedFile.h"
+#include "UnixSocketTransport.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Test client for the core's Unix socket: connects like the UI would, sends
+// a preset as ADD_OVERLAY (then REMOVE_OVERLAY) a number of times, prints
+// every reply and the round-trip time of each request.
+//
+//   IPCClient [--socket <path>] [--count <n>] [--id <overlay id>] <preset.json>
+//
+// The core answers between frames as soon as a request arrives, so a round
+// trip is the transport both ways plus handling the request: REMOVE_OVERLAY
+// is close to the bare transport, ADD_OVERLAY adds parsing the preset.
+namespace
+{
+    const char* TypeName(IPCMessageType type)
+    {
+        switch (type)
+        {
+        case IPCMessageType::DISPLAY_ALL: return "DISPLAY_ALL";
+        case IPCMessageType::CLOSE_ALL: return "CLOSE_ALL";
+        case IPCMessageType::SHOW_OVERLAY: return "SHOW_OVERLAY";
+        case IPCMessageType::CLOSE_OVERLAY: return "CLOSE_OVERLAY";
+        case IPCMessageType::ADD_OVERLAY: return "ADD_OVERLAY";
+        case IPCMessageType::REMOVE_OVERLAY: return "REMOVE_OVERLAY";
+        case IPCMessageType::UPDATE_OVERLAY: return "UPDATE_OVERLAY";
+        case IPCMessageType::STATUS_UPDATE: return "STATUS_UPDATE";
+        case IPCMessageType::MOUSE_EVENT: return "MOUSE_EVENT";
+        }
+        return "unknown";
+    }
+
+    bool Send(IPCTransport& transport, const IPCMessage& message, std::string& frame)
+    {
+        size_t offset = 0;
+        do
+        {
+            frame.clear();
+            offset += IPCProtocol::EncodeFrame(message, offset, frame);
+            if (!transport.Write(frame))
+                return false;
+        } while (offset < message.data.size());
+        return true;
+    }
+
+    // Reads until the reply to 'correlationId' arrives; other messages (mouse
+    // events of a running core) are listed and skipped
+    bool WaitForReply(IPCTransport& transport, uint32_t correlationId, IPCMessage& reply)
+    {
+        std::string frame;
+        IPCProtocol::MessageAssembler assembler;
+        while (transport.Read(frame))
+        {
+            if (assembler.Feed(frame, reply) != IPCProtocol::MessageAssembler::Result::Complete)
+                continue;
+            if (reply.correlationId == correlationId)
+                return true;
+            std::printf("  (%s, overlay %d, %zu bytes)\n", TypeName(reply.type), reply.overlayId, reply.data.size());
+        }
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string socketPath = UnixSocketTransport::DefaultPath();
+    std::string presetPath;
+    int count = 10;
+    int overlayId = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (arg == "--count" && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--id" && i + 1 < argc)
+            overlayId = std::atoi(argv[++i]);
+        else
+            presetPath = arg;
+    }
+
+    MappedFile preset;
+    if (presetPath.empty() || !preset.Open(presetPath))
+    {
+        std::fprintf(stderr, "Usage: IPCClient [--socket <path>] [--count <n>] [--id <overlay id>] <preset.json>\n");
+        return 2;
+    }
+
+    UnixSocketTransport transport(socketPath, UnixSocketTransport::Role::Client);
+    if (!transport.Initialize())
+        return 1;
+    std::printf("Connected to %s\n", socketPath.c_str());
+
+    IPCMessage add;
+    add.type = IPCMessageType::ADD_OVERLAY;
+    add.overlayId = overlayId;
+    add.data.assign(reinterpret_cast<const char*>(preset.Data()), preset.Size());
+
+    IPCMessage remove;
+    remove.type = IPCMessageType::REMOVE_OVERLAY;
+    remove.overlayId = overlayId;
+
+    std::string frame;
+    IPCMessage reply;
+    std::vector<double> roundTripsMs[2]; // ADD_OVERLAY, REMOVE_OVERLAY
+    uint32_t correlationId = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        for (int kind = 0; kind < 2; ++kind)
+        {
+            IPCMessage* request = kind == 0 ? &add : &remove;
+            request->correlationId = ++correlationId;
+
+            auto start = std::chrono::steady_clock::now();
+            if (!Send(transport, *request, frame) || !WaitForReply(transport, correlationId, reply))
+            {
+                std::fprintf(stderr, "Connection to the core lost\n");
+                return 1;
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            roundTripsMs[kind].push_back(ms);
+
+            std::printf("%-14s #%-4u %zu bytes -> %s \"%s\" in %.3f ms\n", TypeName(request->type), correlationId,
+                        request->data.size(), TypeName(reply.type), reply.data.c_str(), ms);
+        }
+    }
+
+    for (int kind = 0; kind < 2; ++kind)
+    {
+        std::vector<double>& times = roundTripsMs[kind];
+        std::sort(times.begin(), times.end());
+        std::printf("%-14s %zu round trips: min %.3f ms, median %.3f ms, max %.3f ms\n",
+                    kind == 0 ? "ADD_OVERLAY" : "REMOVE_OVERLAY", times.size(),
+                    times.front(), times[times.size() / 2], times.back());
+    }
+    return 0;
+}
\ No newline at end of file